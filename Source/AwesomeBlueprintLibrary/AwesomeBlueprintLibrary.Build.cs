@@ -21,9 +21,12 @@ public class AwesomeBlueprintLibrary : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"DeveloperSettings",
 				"Slate",
 				"SlateCore",
-				"InputCore"
+				"InputCore",
+				"Json",
+				"JsonUtilities"
 			}
 			);
 	}
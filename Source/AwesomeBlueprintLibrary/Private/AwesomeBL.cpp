@@ -1,12 +1,26 @@
 ﻿
 #include "AwesomeBL.h"
 
+#include "AwesomeBLArrayMath.h"
+#include "AwesomeBLAssetSnapshot.h"
+#include "AwesomeBLComponentCache.h"
+#include "AwesomeBLKeepAlive.h"
+#include "AwesomeBLLoadRequest.h"
+#include "AwesomeBLNameBatch.h"
+#include "AwesomeBLPrefetcher.h"
+#include "AwesomeBLProfiling.h"
 #include "BlueprintEditor.h"
 #include "Engine/AssetManager.h"
 
 
 bool UAwesomeBL::GetPrimaryAssetData(const FPrimaryAssetId& PrimaryAssetId, FAssetData& OutAssetData)
 {
+	// The snapshot is only mapped until the asset manager has finished scanning.
+	if (FAwesomeBLAssetSnapshot::Get().GetPrimaryAssetData(PrimaryAssetId, OutAssetData))
+	{
+		return true;
+	}
+
 	if (const UAssetManager* AssetManager = UAssetManager::GetIfInitialized())
 	{
 		return AssetManager->GetPrimaryAssetData(PrimaryAssetId, OutAssetData);
@@ -20,7 +34,7 @@ void UAwesomeBL::AsyncLoadPrimaryAsset(const FPrimaryAssetId& AssetToLoad, const
 {
 	TDelegate<void(const FPrimaryAssetId&, UObject*)> Delegate;
 	Delegate.BindUFunction(const_cast<UObject*>(OnLoad.GetUObject()), OnLoad.GetFunctionName());
-	TAsyncLoadPrimaryAsset<UObject>(AssetToLoad, LoadBundles, Delegate);
+	TAsyncLoadPrimaryAsset<UObject>(AssetToLoad, LoadBundles, MoveTemp(Delegate));
 }
 
 void UAwesomeBL::AsyncLoadPrimaryAssetWithTags(const FPrimaryAssetId& AssetToLoad, const TArray<FName>& LoadBundles, const FAsyncLoadPrimaryAssetWithGameplayTags& OnLoad, const FGameplayTagContainer& Tags)
@@ -30,14 +44,19 @@ void UAwesomeBL::AsyncLoadPrimaryAssetWithTags(const FPrimaryAssetId& AssetToLoa
 	{
 		OnLoad.ExecuteIfBound(AssetToLoad, LoadedObject, Tags);
 	});
-	TAsyncLoadPrimaryAsset<UObject>(AssetToLoad, LoadBundles, Delegate);
+	TAsyncLoadPrimaryAsset<UObject>(AssetToLoad, LoadBundles, MoveTemp(Delegate));
+
+	if (UAwesomeBLPrefetcher* Prefetcher = UAwesomeBLPrefetcher::GetIfEnabled())
+	{
+		Prefetcher->OnTaggedRequest(Tags, MakeArrayView(&AssetToLoad, 1));
+	}
 }
 
 void UAwesomeBL::AsyncLoadPrimaryAssets(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, const FAsyncLoadPrimaryAssetList& OnLoad)
 {
 	TDelegate<void(const TArray<FPrimaryAssetId>&, const TArray<UObject*>&)> Delegate;
 	Delegate.BindUFunction(const_cast<UObject*>(OnLoad.GetUObject()), OnLoad.GetFunctionName());
-	TAsyncLoadPrimaryAssetList(AssetsToLoad, LoadBundles, Delegate);
+	TAsyncLoadPrimaryAssetList(AssetsToLoad, LoadBundles, MoveTemp(Delegate));
 }
 
 void UAwesomeBL::AsyncLoadPrimaryAssetsWithTags(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, const FAsyncLoadPrimaryAssetListWithGameplayTags& OnLoad, const FGameplayTagContainer& Tags)
@@ -47,14 +66,63 @@ void UAwesomeBL::AsyncLoadPrimaryAssetsWithTags(const TArray<FPrimaryAssetId>& A
 	{
 		OnLoad.ExecuteIfBound(AssetsToLoad, LoadedObjects, Tags);
 	});
-	TAsyncLoadPrimaryAssetList(AssetsToLoad, LoadBundles, Delegate);
+	TAsyncLoadPrimaryAssetList(AssetsToLoad, LoadBundles, MoveTemp(Delegate));
+
+	if (UAwesomeBLPrefetcher* Prefetcher = UAwesomeBLPrefetcher::GetIfEnabled())
+	{
+		Prefetcher->OnTaggedRequest(Tags, AssetsToLoad);
+	}
+}
+
+UAwesomeBLLoadRequest* UAwesomeBL::RequestAsyncLoadPrimaryAsset(const FPrimaryAssetId& AssetToLoad, const TArray<FName>& LoadBundles, const FAsyncLoadPrimaryAsset& OnLoad, int32 Priority)
+{
+	// Merged requests share a handle, so a canceled request has to filter out its own callback.
+	UAwesomeBLLoadRequest* Request = UAwesomeBLLoadRequest::Create(nullptr);
+	TDelegate<void(const FPrimaryAssetId&, UObject*)> Delegate;
+	Delegate.BindLambda([OnLoad, WeakRequest = TWeakObjectPtr<UAwesomeBLLoadRequest>(Request)](const FPrimaryAssetId& LoadedAssetId, UObject* LoadedObject)
+	{
+		if (!WeakRequest.IsValid() || !WeakRequest->WasCanceled())
+		{
+			OnLoad.ExecuteIfBound(LoadedAssetId, LoadedObject);
+		}
+	});
+	FAwesomeBLLoadToken Token;
+	TSharedPtr<FStreamableHandle> Handle = TRequestAsyncLoadPrimaryAsset<UObject>(AssetToLoad, LoadBundles, MoveTemp(Delegate), Priority, &Token);
+	Request->SetHandle(MoveTemp(Handle), Token);
+	return Request;
+}
+
+UAwesomeBLLoadRequest* UAwesomeBL::RequestAsyncLoadPrimaryAssets(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, const FAsyncLoadPrimaryAssetList& OnLoad, int32 Priority)
+{
+	UAwesomeBLLoadRequest* Request = UAwesomeBLLoadRequest::Create(nullptr);
+	TDelegate<void(const TArray<FPrimaryAssetId>&, const TArray<UObject*>&)> Delegate;
+	Delegate.BindLambda([OnLoad, WeakRequest = TWeakObjectPtr<UAwesomeBLLoadRequest>(Request)](const TArray<FPrimaryAssetId>& LoadedAssetIds, const TArray<UObject*>& LoadedObjects)
+	{
+		if (!WeakRequest.IsValid() || !WeakRequest->WasCanceled())
+		{
+			OnLoad.ExecuteIfBound(LoadedAssetIds, LoadedObjects);
+		}
+	});
+	FAwesomeBLLoadToken Token;
+	TSharedPtr<FStreamableHandle> Handle = TRequestAsyncLoadPrimaryAssetList(AssetsToLoad, LoadBundles, MoveTemp(Delegate), Priority, &Token);
+	Request->SetHandle(MoveTemp(Handle), Token);
+	return Request;
+}
+
+void UAwesomeBL::AsyncLoadPrimaryAssetsIncremental(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, const FAsyncLoadPrimaryAssetProgress& OnAssetLoaded, const FAsyncLoadPrimaryAssetList& OnLoad)
+{
+	TDelegate<void(const FPrimaryAssetId&, UObject*, const FAwesomeBLLoadProgress&)> AssetDelegate;
+	AssetDelegate.BindUFunction(const_cast<UObject*>(OnAssetLoaded.GetUObject()), OnAssetLoaded.GetFunctionName());
+	TDelegate<void(const TArray<FPrimaryAssetId>&, const TArray<UObject*>&)> Delegate;
+	Delegate.BindUFunction(const_cast<UObject*>(OnLoad.GetUObject()), OnLoad.GetFunctionName());
+	TStreamAsyncLoadPrimaryAssetList(AssetsToLoad, LoadBundles, AssetDelegate, MoveTemp(Delegate));
 }
 
 void UAwesomeBL::AsyncLoadAsset(const TSoftObjectPtr<UObject> AssetToLoad, const FAsyncLoadAsset& OnLoad)
 {
 	TDelegate<void(UObject*)> Delegate;
 	Delegate.BindUFunction(const_cast<UObject*>(OnLoad.GetUObject()), OnLoad.GetFunctionName());
-	TAsyncLoadAsset(AssetToLoad, Delegate);
+	TAsyncLoadAsset(AssetToLoad, MoveTemp(Delegate));
 }
 
 void UAwesomeBL::AsyncLoadAssetWithNameTags(const TSoftObjectPtr<UObject> AssetToLoad, const TArray<FName>& Tags, const FAsyncLoadAssetWithNameTags& OnLoad)
@@ -64,14 +132,14 @@ void UAwesomeBL::AsyncLoadAssetWithNameTags(const TSoftObjectPtr<UObject> AssetT
 	{
 		OnLoad.ExecuteIfBound(LoadedObject, Tags);
 	});
-	TAsyncLoadAsset(AssetToLoad, Delegate);
+	TAsyncLoadAsset(AssetToLoad, MoveTemp(Delegate));
 }
 
 void UAwesomeBL::AsyncLoadAssets(const TArray<TSoftObjectPtr<UObject>>& AssetListToLoad, const FAsyncLoadAssetList& OnLoad)
 {
 	TDelegate<void(const TArray<UObject*>&)> Delegate;
 	Delegate.BindUFunction(const_cast<UObject*>(OnLoad.GetUObject()), OnLoad.GetFunctionName());
-	TAsyncLoadAssets(AssetListToLoad, Delegate);
+	TAsyncLoadAssets(AssetListToLoad, MoveTemp(Delegate));
 }
 
 void UAwesomeBL::AsyncLoadAssetsWithNameTags(const TArray<TSoftObjectPtr<UObject>>& AssetListToLoad, const TArray<FName>& Tags, const FAsyncLoadAssetListWithNameTags& OnLoad)
@@ -81,31 +149,84 @@ void UAwesomeBL::AsyncLoadAssetsWithNameTags(const TArray<TSoftObjectPtr<UObject
 	{
 		OnLoad.ExecuteIfBound(LoadedObject, Tags);
 	});
-	TAsyncLoadAssets(AssetListToLoad, Delegate);
+	TAsyncLoadAssets(AssetListToLoad, MoveTemp(Delegate));
 }
 
-void UAwesomeBL::NameArrayToStringArray(const TArray<FName>& Source, TArray<FString>& Target)
+void UAwesomeBL::AsyncLoadAssetsIncremental(const TArray<TSoftObjectPtr<UObject>>& AssetListToLoad, const FAsyncLoadAssetProgress& OnAssetLoaded, const FAsyncLoadAssetList& OnLoad)
+{
+	TDelegate<void(int32, UObject*, const FAwesomeBLLoadProgress&)> AssetDelegate;
+	AssetDelegate.BindLambda([OnAssetLoaded](int32 Index, UObject* LoadedObject, const FAwesomeBLLoadProgress& Progress)
+	{
+		OnAssetLoaded.ExecuteIfBound(LoadedObject, Index, Progress);
+	});
+	TDelegate<void(const TArray<UObject*>&)> Delegate;
+	Delegate.BindUFunction(const_cast<UObject*>(OnLoad.GetUObject()), OnLoad.GetFunctionName());
+	TStreamAsyncLoadAssets(AssetListToLoad, AssetDelegate, MoveTemp(Delegate));
+}
+
+UAwesomeBLLoadRequest* UAwesomeBL::RequestAsyncLoadAsset(const TSoftObjectPtr<UObject> AssetToLoad, const FAsyncLoadAsset& OnLoad, int32 Priority)
+{
+	UAwesomeBLLoadRequest* Request = UAwesomeBLLoadRequest::Create(nullptr);
+	TDelegate<void(UObject*)> Delegate;
+	Delegate.BindLambda([OnLoad, WeakRequest = TWeakObjectPtr<UAwesomeBLLoadRequest>(Request)](UObject* LoadedObject)
+	{
+		if (!WeakRequest.IsValid() || !WeakRequest->WasCanceled())
+		{
+			OnLoad.ExecuteIfBound(LoadedObject);
+		}
+	});
+	FAwesomeBLLoadToken Token;
+	TSharedPtr<FStreamableHandle> Handle = TRequestAsyncLoadAsset(AssetToLoad, MoveTemp(Delegate), Priority, &Token);
+	Request->SetHandle(MoveTemp(Handle), Token);
+	return Request;
+}
+
+UAwesomeBLLoadRequest* UAwesomeBL::RequestAsyncLoadAssets(const TArray<TSoftObjectPtr<UObject>>& AssetListToLoad, const FAsyncLoadAssetList& OnLoad, int32 Priority)
+{
+	UAwesomeBLLoadRequest* Request = UAwesomeBLLoadRequest::Create(nullptr);
+	TDelegate<void(const TArray<UObject*>&)> Delegate;
+	Delegate.BindLambda([OnLoad, WeakRequest = TWeakObjectPtr<UAwesomeBLLoadRequest>(Request)](const TArray<UObject*>& LoadedObjects)
+	{
+		if (!WeakRequest.IsValid() || !WeakRequest->WasCanceled())
+		{
+			OnLoad.ExecuteIfBound(LoadedObjects);
+		}
+	});
+	FAwesomeBLLoadToken Token;
+	TSharedPtr<FStreamableHandle> Handle = TRequestAsyncLoadAssets(AssetListToLoad, MoveTemp(Delegate), Priority, &Token);
+	Request->SetHandle(MoveTemp(Handle), Token);
+	return Request;
+}
+
+void UAwesomeBL::GetLoadCoalescingStats(int32& NumRequests, int32& NumMergedRequests, bool bReset)
 {
-	Target.Reset(Source.Num());
-	for (const FName& Name : Source)
+	FAwesomeBLLoadCoalescer& Coalescer = FAwesomeBLLoadCoalescer::Get();
+	NumRequests = Coalescer.GetNumRequests();
+	NumMergedRequests = Coalescer.GetNumMergedRequests();
+	if (bReset)
 	{
-		Target.Emplace(Name.ToString());
+		Coalescer.ResetStats();
 	}
 }
 
+void UAwesomeBL::NameArrayToStringArray(const TArray<FName>& Source, TArray<FString>& Target)
+{
+	FAwesomeBLNameBatch::ToStrings(Source, Target);
+}
+
 void UAwesomeBL::StringArrayToNameArray(const TArray<FString>& Source, TArray<FName>& Target)
 {
-	ConvertArray(Source, Target);
+	FAwesomeBLNameBatch::ToNames(Source, Target);
 }
 
 void UAwesomeBL::IntArrayToFloatArray(const TArray<int32>& Source, TArray<float>& Target)
 {
-	ConvertArray(Source, Target);
+	UAwesomeBLArrayMath::IntToFloatArray(Source, Target);
 }
 
 void UAwesomeBL::FloatArrayToIntArray(const TArray<float>& Source, TArray<int32>& Target)
 {
-	ConvertArray(Source, Target);
+	UAwesomeBLArrayMath::FloatToIntArray(Source, EAwesomeBLRoundingMode::Truncate, Target);
 }
 
 void UAwesomeBL::QuitGame()
@@ -115,22 +236,22 @@ void UAwesomeBL::QuitGame()
 
 void UAwesomeBL::RegisterWithGameInstance(const UObject* WorldContextObject, UObject* Object)
 {
-	if (WorldContextObject && Object)
+	if (Object)
 	{
-		if (UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject))
+		if (UAwesomeBLKeepAlive* KeepAlive = UAwesomeBLKeepAlive::Get(WorldContextObject))
 		{
-			GameInstance->RegisterReferencedObject(Object);
+			KeepAlive->Register(Object);
 		}
 	}
 }
 
 void UAwesomeBL::UnregisterWithGameInstance(const UObject* WorldContextObject, UObject* Object)
 {
-	if (WorldContextObject && Object)
+	if (Object)
 	{
-		if (UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContextObject))
+		if (UAwesomeBLKeepAlive* KeepAlive = UAwesomeBLKeepAlive::Get(WorldContextObject))
 		{
-			GameInstance->UnregisterReferencedObject(Object);
+			KeepAlive->Unregister(Object);
 		}
 	}
 }
@@ -140,58 +261,99 @@ void UAwesomeBL::DebugBreak()
 	UE_DEBUG_BREAK();
 }
 
-void UAwesomeBL::InjectControllerAnalog(const FKey& Key, const float AnalogValue, const bool bRepeat)
+void UAwesomeBL::BeginProfilingScope(FName Name)
 {
-	const uint32* KeyCodePtr;
-	const uint32* CharCodePtr;
-	FInputKeyManager::Get().GetCodesFromKey(Key, KeyCodePtr, CharCodePtr);
+	FAwesomeBLProfiling::BeginScope(Name);
+}
 
-	const uint32 KeyCode = KeyCodePtr ? *KeyCodePtr : 0;
-	const uint32 CharCode = CharCodePtr ? *CharCodePtr : 0;
+void UAwesomeBL::EndProfilingScope(FName Name)
+{
+	FAwesomeBLProfiling::EndScope(Name);
+}
 
-	const FAnalogInputEvent AnalogInputEvent(Key, FModifierKeysState(), 0, bRepeat, CharCode, KeyCode, AnalogValue );
-	FSlateApplication::Get().ProcessAnalogInputEvent(AnalogInputEvent);
-	
+void UAwesomeBL::InjectControllerAnalog(const FKey& Key, const float AnalogValue, const bool bRepeat)
+{
+	FAwesomeBLInputEvent Event;
+	Event.Type = EAwesomeBLInputEventType::Analog;
+	Event.Key = Key;
+	Event.AnalogValue = AnalogValue;
+	Event.bRepeat = bRepeat;
+	Event.PrepareCodes();
+	Event.Inject();
 }
 
 void UAwesomeBL::InjectControllerButtonPress(const FKey& Key, const bool bRepeat)
 {
-	const uint32* KeyCodePtr;
-	const uint32* CharCodePtr;
-	FInputKeyManager::Get().GetCodesFromKey(Key, KeyCodePtr, CharCodePtr);
+	FAwesomeBLInputEvent Event;
+	Event.Type = EAwesomeBLInputEventType::Pressed;
+	Event.Key = Key;
+	Event.bRepeat = bRepeat;
+	Event.PrepareCodes();
+	Event.Inject();
+}
 
-	const uint32 KeyCode = KeyCodePtr ? *KeyCodePtr : 0;
-	const uint32 CharCode = CharCodePtr ? *CharCodePtr : 0;
+void UAwesomeBL::InjectControllerButtonReleased(const FKey& Key, const bool bRepeat)
+{
+	FAwesomeBLInputEvent Event;
+	Event.Type = EAwesomeBLInputEventType::Released;
+	Event.Key = Key;
+	Event.bRepeat = bRepeat;
+	Event.PrepareCodes();
+	Event.Inject();
+}
 
-	FKeyEvent KeyEvent(Key, FModifierKeysState(), 0, bRepeat, KeyCode, CharCode);
-	const bool DownResult = FSlateApplication::Get().ProcessKeyDownEvent(KeyEvent);
+void UAwesomeBL::StartInputRecording()
+{
+	FAwesomeBLInputTrackPlayer::Get().StartRecording();
+}
 
-	if (CharCodePtr)
-	{
-		FCharacterEvent CharacterEvent(CharCode, FModifierKeysState(), 0, bRepeat);
-		FSlateApplication::Get().ProcessKeyCharEvent(CharacterEvent);
-	}
+FAwesomeBLInputTrack UAwesomeBL::StopInputRecording()
+{
+	return FAwesomeBLInputTrackPlayer::Get().StopRecording();
 }
 
-void UAwesomeBL::InjectControllerButtonReleased(const FKey& Key, const bool bRepeat)
+void UAwesomeBL::PlayInputTrack(const FAwesomeBLInputTrack& Track)
+{
+	FAwesomeBLInputTrackPlayer::Get().Play(Track);
+}
+
+void UAwesomeBL::StopInputTrack()
+{
+	FAwesomeBLInputTrackPlayer::Get().Stop();
+}
+
+bool UAwesomeBL::IsPlayingInputTrack()
 {
-	const uint32* KeyCodePtr;
-	const uint32* CharCodePtr;
-	FInputKeyManager::Get().GetCodesFromKey(Key, KeyCodePtr, CharCodePtr);
+	return FAwesomeBLInputTrackPlayer::Get().IsPlaying();
+}
 
-	const uint32 KeyCode = KeyCodePtr ? *KeyCodePtr : 0;
-	const uint32 CharCode = CharCodePtr ? *CharCodePtr : 0;
+bool UAwesomeBL::SaveInputTrack(const FAwesomeBLInputTrack& Track, const FString& Filename)
+{
+	return Track.SaveToFile(FPaths::IsRelative(Filename) ? FPaths::Combine(FPaths::ProjectDir(), Filename) : Filename);
+}
 
-	FKeyEvent KeyEvent(Key, FModifierKeysState(), 0, bRepeat, KeyCode, CharCode);
-	FSlateApplication::Get().ProcessKeyUpEvent(KeyEvent);
+bool UAwesomeBL::LoadInputTrack(const FString& Filename, FAwesomeBLInputTrack& OutTrack)
+{
+	return OutTrack.LoadFromFile(FPaths::IsRelative(Filename) ? FPaths::Combine(FPaths::ProjectDir(), Filename) : Filename);
 }
 
 UActorComponent* UAwesomeBL::GetComponent(const FComponentReference& ComponentReference, AActor* OwningActor)
 {
-	return ComponentReference.GetComponent(OwningActor);
+	return FAwesomeBLComponentCache::Get().GetComponent(ComponentReference, OwningActor);
 }
 
 UActorComponent* UAwesomeBL::GetComponentSoft(const FSoftComponentReference& ComponentReference, AActor* OwningActor)
 {
-	return ComponentReference.GetComponent(OwningActor);
+	return FAwesomeBLComponentCache::Get().GetComponent(ComponentReference, OwningActor);
+}
+
+void UAwesomeBL::GetComponentCacheStats(int32& NumHits, int32& NumMisses, bool bReset)
+{
+	FAwesomeBLComponentCache& Cache = FAwesomeBLComponentCache::Get();
+	NumHits = Cache.GetNumHits();
+	NumMisses = Cache.GetNumMisses();
+	if (bReset)
+	{
+		Cache.ResetStats();
+	}
 }
@@ -0,0 +1,484 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLArrayMath.h"
+
+#include "Math/VectorRegister.h"
+
+namespace AwesomeBLArrayMath
+{
+	static_assert(sizeof(FVector) == 3 * sizeof(FVector::FReal), "Vector arrays are processed as flat arrays of components");
+
+	FORCEINLINE VectorRegister4Float Load(const float* Ptr) { return VectorLoad(Ptr); }
+	FORCEINLINE VectorRegister4Double Load(const double* Ptr) { return VectorLoad(Ptr); }
+	FORCEINLINE VectorRegister4Int Load(const int32* Ptr) { return VectorIntLoad(Ptr); }
+
+	FORCEINLINE void Store(const VectorRegister4Float& Value, float* Ptr) { VectorStore(Value, Ptr); }
+	FORCEINLINE void Store(const VectorRegister4Double& Value, double* Ptr) { VectorStore(Value, Ptr); }
+	FORCEINLINE void Store(const VectorRegister4Int& Value, int32* Ptr) { VectorIntStore(Value, Ptr); }
+
+	FORCEINLINE VectorRegister4Double SetDouble(double Value) { return MakeVectorRegisterDouble(Value, Value, Value, Value); }
+
+	FORCEINLINE const FVector::FReal* GetComponents(const TArray<FVector>& Values) { return reinterpret_cast<const FVector::FReal*>(Values.GetData()); }
+	FORCEINLINE FVector::FReal* GetComponents(TArray<FVector>& Values) { return reinterpret_cast<FVector::FReal*>(Values.GetData()); }
+
+	/** Size Target to Num elements without initializing them, keeping its allocation when large enough */
+	template<typename Type>
+	void ResizeUninitialized(TArray<Type>& Target, int32 Num)
+	{
+		Target.Reset(Num);
+		Target.AddUninitialized(Num);
+	}
+
+	/**
+	 * Run Op over Num elements four at a time. The last partial register goes through a zero padded copy so the tail
+	 * uses the same operation as the body. Source and Target may be the same array.
+	 */
+	template<typename SourceType, typename TargetType, typename OpType>
+	void Transform(const SourceType* Source, TargetType* Target, int32 Num, OpType Op)
+	{
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			Store(Op(Load(Source + Index)), Target + Index);
+		}
+
+		if (Index < Num)
+		{
+			SourceType SourceTail[4] = {};
+			TargetType TargetTail[4];
+			FMemory::Memcpy(SourceTail, Source + Index, (Num - Index) * sizeof(SourceType));
+			Store(Op(Load(SourceTail)), TargetTail);
+			FMemory::Memcpy(Target + Index, TargetTail, (Num - Index) * sizeof(TargetType));
+		}
+	}
+
+	/** Binary version of Transform, Target may be A or B */
+	template<typename Type, typename OpType>
+	void Transform(const Type* A, const Type* B, Type* Target, int32 Num, OpType Op)
+	{
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			Store(Op(Load(A + Index), Load(B + Index)), Target + Index);
+		}
+
+		if (Index < Num)
+		{
+			Type ATail[4] = {};
+			Type BTail[4] = {};
+			FMemory::Memcpy(ATail, A + Index, (Num - Index) * sizeof(Type));
+			FMemory::Memcpy(BTail, B + Index, (Num - Index) * sizeof(Type));
+			Store(Op(Load(ATail), Load(BTail)), ATail);
+			FMemory::Memcpy(Target + Index, ATail, (Num - Index) * sizeof(Type));
+		}
+	}
+
+	/**
+	 * Three registers repeating X, Y and Z over twelve components. Four vectors fill three registers exactly, so
+	 * register N of every group of four vectors lines up with Phases[N].
+	 */
+	struct FVectorPattern
+	{
+		VectorRegister4Double Phases[3];
+
+		explicit FVectorPattern(const FVector& Vector)
+			: Phases{
+				MakeVectorRegisterDouble(Vector.X, Vector.Y, Vector.Z, Vector.X),
+				MakeVectorRegisterDouble(Vector.Y, Vector.Z, Vector.X, Vector.Y),
+				MakeVectorRegisterDouble(Vector.Z, Vector.X, Vector.Y, Vector.Z) }
+		{
+		}
+	};
+
+	/** Run Op over Num vectors, four vectors at a time. Op gets the register and its phase in FVectorPattern */
+	template<typename OpType>
+	void TransformVectors(const FVector::FReal* Source, FVector::FReal* Target, int32 Num, OpType Op)
+	{
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			const int32 Offset = Index * 3;
+			Store(Op(Load(Source + Offset), 0), Target + Offset);
+			Store(Op(Load(Source + Offset + 4), 1), Target + Offset + 4);
+			Store(Op(Load(Source + Offset + 8), 2), Target + Offset + 8);
+		}
+
+		if (Index < Num)
+		{
+			const int32 NumTailComponents = (Num - Index) * 3;
+			FVector::FReal Tail[12] = {};
+			FMemory::Memcpy(Tail, Source + Index * 3, NumTailComponents * sizeof(FVector::FReal));
+			Store(Op(Load(Tail), 0), Tail);
+			Store(Op(Load(Tail + 4), 1), Tail + 4);
+			Store(Op(Load(Tail + 8), 2), Tail + 8);
+			FMemory::Memcpy(Target + Index * 3, Tail, NumTailComponents * sizeof(FVector::FReal));
+		}
+	}
+
+	/** Fold twelve components, as stored from three phase registers, into one vector with Op */
+	template<typename OpType>
+	FVector FoldPhases(const VectorRegister4Double (&Registers)[3], OpType Op)
+	{
+		FVector::FReal Components[12];
+		Store(Registers[0], Components);
+		Store(Registers[1], Components + 4);
+		Store(Registers[2], Components + 8);
+
+		FVector Result(Components[0], Components[1], Components[2]);
+		for (int32 Index = 3; Index < 12; Index += 3)
+		{
+			Result.X = Op(Result.X, Components[Index]);
+			Result.Y = Op(Result.Y, Components[Index + 1]);
+			Result.Z = Op(Result.Z, Components[Index + 2]);
+		}
+		return Result;
+	}
+}
+
+void UAwesomeBLArrayMath::IntToFloatArray(const TArray<int32>& Source, TArray<float>& Target)
+{
+	using namespace AwesomeBLArrayMath;
+
+	ResizeUninitialized(Target, Source.Num());
+	Transform(Source.GetData(), Target.GetData(), Source.Num(), [](const VectorRegister4Int& Value) { return VectorIntToFloat(Value); });
+}
+
+void UAwesomeBLArrayMath::FloatToIntArray(const TArray<float>& Source, EAwesomeBLRoundingMode RoundingMode, TArray<int32>& Target)
+{
+	using namespace AwesomeBLArrayMath;
+
+	ResizeUninitialized(Target, Source.Num());
+	const float* SourceData = Source.GetData();
+	int32* TargetData = Target.GetData();
+	const int32 Num = Source.Num();
+
+	// Branch once per array, not per register.
+	switch (RoundingMode)
+	{
+	case EAwesomeBLRoundingMode::Truncate:
+		Transform(SourceData, TargetData, Num, [](const VectorRegister4Float& Value) { return VectorFloatToInt(Value); });
+		break;
+	case EAwesomeBLRoundingMode::Floor:
+		Transform(SourceData, TargetData, Num, [](const VectorRegister4Float& Value) { return VectorFloatToInt(VectorFloor(Value)); });
+		break;
+	case EAwesomeBLRoundingMode::Ceil:
+		Transform(SourceData, TargetData, Num, [](const VectorRegister4Float& Value) { return VectorFloatToInt(VectorCeil(Value)); });
+		break;
+	case EAwesomeBLRoundingMode::Round:
+		{
+			const VectorRegister4Float Half = VectorSetFloat1(0.5f);
+			Transform(SourceData, TargetData, Num, [Half](const VectorRegister4Float& Value) { return VectorFloatToInt(VectorFloor(VectorAdd(Value, Half))); });
+		}
+		break;
+	case EAwesomeBLRoundingMode::RoundHalfToEven:
+		Transform(SourceData, TargetData, Num, [](const VectorRegister4Float& Value) { return VectorRoundToIntHalfToEven(Value); });
+		break;
+	default:
+		checkNoEntry();
+	}
+}
+
+float UAwesomeBLArrayMath::SumFloatArray(const TArray<float>& Values)
+{
+	using namespace AwesomeBLArrayMath;
+
+	const float* Data = Values.GetData();
+	VectorRegister4Float Sum = VectorZeroFloat();
+	int32 Index = 0;
+	for (; Index + 4 <= Values.Num(); Index += 4)
+	{
+		Sum = VectorAdd(Sum, Load(Data + Index));
+	}
+
+	float Lanes[4];
+	Store(Sum, Lanes);
+	double Result = static_cast<double>(Lanes[0]) + Lanes[1] + Lanes[2] + Lanes[3];
+	for (; Index < Values.Num(); ++Index)
+	{
+		Result += Data[Index];
+	}
+	return static_cast<float>(Result);
+}
+
+int64 UAwesomeBLArrayMath::SumIntArray(const TArray<int32>& Values)
+{
+	// 32 bit lanes would overflow long before the sum does, a plain 64 bit loop is left to the compiler to vectorize.
+	int64 Result = 0;
+	for (const int32 Value : Values)
+	{
+		Result += Value;
+	}
+	return Result;
+}
+
+FVector UAwesomeBLArrayMath::SumVectorArray(const TArray<FVector>& Values)
+{
+	using namespace AwesomeBLArrayMath;
+
+	const FVector::FReal* Components = GetComponents(Values);
+	VectorRegister4Double Sums[3] = { VectorZeroDouble(), VectorZeroDouble(), VectorZeroDouble() };
+	int32 Index = 0;
+	for (; Index + 4 <= Values.Num(); Index += 4)
+	{
+		const int32 Offset = Index * 3;
+		Sums[0] = VectorAdd(Sums[0], Load(Components + Offset));
+		Sums[1] = VectorAdd(Sums[1], Load(Components + Offset + 4));
+		Sums[2] = VectorAdd(Sums[2], Load(Components + Offset + 8));
+	}
+
+	FVector Result = FoldPhases(Sums, [](FVector::FReal A, FVector::FReal B) { return A + B; });
+	for (; Index < Values.Num(); ++Index)
+	{
+		Result += Values[Index];
+	}
+	return Result;
+}
+
+bool UAwesomeBLArrayMath::GetFloatArrayMinMax(const TArray<float>& Values, float& Min, float& Max)
+{
+	using namespace AwesomeBLArrayMath;
+
+	if (Values.IsEmpty())
+	{
+		return false;
+	}
+
+	const float* Data = Values.GetData();
+	VectorRegister4Float MinValue = VectorSetFloat1(Data[0]);
+	VectorRegister4Float MaxValue = MinValue;
+	int32 Index = 0;
+	for (; Index + 4 <= Values.Num(); Index += 4)
+	{
+		const VectorRegister4Float Value = Load(Data + Index);
+		MinValue = VectorMin(MinValue, Value);
+		MaxValue = VectorMax(MaxValue, Value);
+	}
+
+	float MinLanes[4];
+	float MaxLanes[4];
+	Store(MinValue, MinLanes);
+	Store(MaxValue, MaxLanes);
+	Min = FMath::Min(FMath::Min(MinLanes[0], MinLanes[1]), FMath::Min(MinLanes[2], MinLanes[3]));
+	Max = FMath::Max(FMath::Max(MaxLanes[0], MaxLanes[1]), FMath::Max(MaxLanes[2], MaxLanes[3]));
+	for (; Index < Values.Num(); ++Index)
+	{
+		Min = FMath::Min(Min, Data[Index]);
+		Max = FMath::Max(Max, Data[Index]);
+	}
+	return true;
+}
+
+bool UAwesomeBLArrayMath::GetIntArrayMinMax(const TArray<int32>& Values, int32& Min, int32& Max)
+{
+	using namespace AwesomeBLArrayMath;
+
+	if (Values.IsEmpty())
+	{
+		return false;
+	}
+
+	const int32* Data = Values.GetData();
+	VectorRegister4Int MinValue = VectorIntSet1(Data[0]);
+	VectorRegister4Int MaxValue = MinValue;
+	int32 Index = 0;
+	for (; Index + 4 <= Values.Num(); Index += 4)
+	{
+		const VectorRegister4Int Value = Load(Data + Index);
+		MinValue = VectorIntMin(MinValue, Value);
+		MaxValue = VectorIntMax(MaxValue, Value);
+	}
+
+	int32 MinLanes[4];
+	int32 MaxLanes[4];
+	Store(MinValue, MinLanes);
+	Store(MaxValue, MaxLanes);
+	Min = FMath::Min(FMath::Min(MinLanes[0], MinLanes[1]), FMath::Min(MinLanes[2], MinLanes[3]));
+	Max = FMath::Max(FMath::Max(MaxLanes[0], MaxLanes[1]), FMath::Max(MaxLanes[2], MaxLanes[3]));
+	for (; Index < Values.Num(); ++Index)
+	{
+		Min = FMath::Min(Min, Data[Index]);
+		Max = FMath::Max(Max, Data[Index]);
+	}
+	return true;
+}
+
+bool UAwesomeBLArrayMath::GetVectorArrayBounds(const TArray<FVector>& Values, FVector& Min, FVector& Max)
+{
+	using namespace AwesomeBLArrayMath;
+
+	if (Values.IsEmpty())
+	{
+		return false;
+	}
+
+	const FVector::FReal* Components = GetComponents(Values);
+	const FVectorPattern First(Values[0]);
+	VectorRegister4Double MinValues[3] = { First.Phases[0], First.Phases[1], First.Phases[2] };
+	VectorRegister4Double MaxValues[3] = { First.Phases[0], First.Phases[1], First.Phases[2] };
+	int32 Index = 0;
+	for (; Index + 4 <= Values.Num(); Index += 4)
+	{
+		const int32 Offset = Index * 3;
+		for (int32 Phase = 0; Phase < 3; ++Phase)
+		{
+			const VectorRegister4Double Value = Load(Components + Offset + Phase * 4);
+			MinValues[Phase] = VectorMin(MinValues[Phase], Value);
+			MaxValues[Phase] = VectorMax(MaxValues[Phase], Value);
+		}
+	}
+
+	Min = FoldPhases(MinValues, [](FVector::FReal A, FVector::FReal B) { return FMath::Min(A, B); });
+	Max = FoldPhases(MaxValues, [](FVector::FReal A, FVector::FReal B) { return FMath::Max(A, B); });
+	for (; Index < Values.Num(); ++Index)
+	{
+		Min = Min.ComponentMin(Values[Index]);
+		Max = Max.ComponentMax(Values[Index]);
+	}
+	return true;
+}
+
+void UAwesomeBLArrayMath::ScaleFloatArray(const TArray<float>& Source, float Scale, TArray<float>& Target)
+{
+	AwesomeBLArrayMath::ResizeUninitialized(Target, Source.Num());
+	const VectorRegister4Float ScaleValue = VectorSetFloat1(Scale);
+	AwesomeBLArrayMath::Transform(Source.GetData(), Target.GetData(), Source.Num(), [ScaleValue](const VectorRegister4Float& Value) { return VectorMultiply(Value, ScaleValue); });
+}
+
+void UAwesomeBLArrayMath::ScaleFloatArrayInPlace(TArray<float>& Values, float Scale)
+{
+	const VectorRegister4Float ScaleValue = VectorSetFloat1(Scale);
+	AwesomeBLArrayMath::Transform(Values.GetData(), Values.GetData(), Values.Num(), [ScaleValue](const VectorRegister4Float& Value) { return VectorMultiply(Value, ScaleValue); });
+}
+
+void UAwesomeBLArrayMath::ScaleIntArray(const TArray<int32>& Source, int32 Scale, TArray<int32>& Target)
+{
+	AwesomeBLArrayMath::ResizeUninitialized(Target, Source.Num());
+	const VectorRegister4Int ScaleValue = VectorIntSet1(Scale);
+	AwesomeBLArrayMath::Transform(Source.GetData(), Target.GetData(), Source.Num(), [ScaleValue](const VectorRegister4Int& Value) { return VectorIntMultiply(Value, ScaleValue); });
+}
+
+void UAwesomeBLArrayMath::ScaleIntArrayInPlace(TArray<int32>& Values, int32 Scale)
+{
+	const VectorRegister4Int ScaleValue = VectorIntSet1(Scale);
+	AwesomeBLArrayMath::Transform(Values.GetData(), Values.GetData(), Values.Num(), [ScaleValue](const VectorRegister4Int& Value) { return VectorIntMultiply(Value, ScaleValue); });
+}
+
+void UAwesomeBLArrayMath::ScaleVectorArray(const TArray<FVector>& Source, FVector Scale, TArray<FVector>& Target)
+{
+	using namespace AwesomeBLArrayMath;
+
+	ResizeUninitialized(Target, Source.Num());
+	const FVectorPattern ScalePattern(Scale);
+	TransformVectors(GetComponents(Source), GetComponents(Target), Source.Num(), [&ScalePattern](const VectorRegister4Double& Value, int32 Phase) { return VectorMultiply(Value, ScalePattern.Phases[Phase]); });
+}
+
+void UAwesomeBLArrayMath::ScaleVectorArrayInPlace(TArray<FVector>& Values, FVector Scale)
+{
+	using namespace AwesomeBLArrayMath;
+
+	const FVectorPattern ScalePattern(Scale);
+	TransformVectors(GetComponents(Values), GetComponents(Values), Values.Num(), [&ScalePattern](const VectorRegister4Double& Value, int32 Phase) { return VectorMultiply(Value, ScalePattern.Phases[Phase]); });
+}
+
+void UAwesomeBLArrayMath::ClampFloatArray(const TArray<float>& Source, float Min, float Max, TArray<float>& Target)
+{
+	AwesomeBLArrayMath::ResizeUninitialized(Target, Source.Num());
+	const VectorRegister4Float MinValue = VectorSetFloat1(Min);
+	const VectorRegister4Float MaxValue = VectorSetFloat1(Max);
+	AwesomeBLArrayMath::Transform(Source.GetData(), Target.GetData(), Source.Num(), [MinValue, MaxValue](const VectorRegister4Float& Value) { return VectorMin(VectorMax(Value, MinValue), MaxValue); });
+}
+
+void UAwesomeBLArrayMath::ClampFloatArrayInPlace(TArray<float>& Values, float Min, float Max)
+{
+	const VectorRegister4Float MinValue = VectorSetFloat1(Min);
+	const VectorRegister4Float MaxValue = VectorSetFloat1(Max);
+	AwesomeBLArrayMath::Transform(Values.GetData(), Values.GetData(), Values.Num(), [MinValue, MaxValue](const VectorRegister4Float& Value) { return VectorMin(VectorMax(Value, MinValue), MaxValue); });
+}
+
+void UAwesomeBLArrayMath::ClampIntArray(const TArray<int32>& Source, int32 Min, int32 Max, TArray<int32>& Target)
+{
+	AwesomeBLArrayMath::ResizeUninitialized(Target, Source.Num());
+	const VectorRegister4Int MinValue = VectorIntSet1(Min);
+	const VectorRegister4Int MaxValue = VectorIntSet1(Max);
+	AwesomeBLArrayMath::Transform(Source.GetData(), Target.GetData(), Source.Num(), [MinValue, MaxValue](const VectorRegister4Int& Value) { return VectorIntMin(VectorIntMax(Value, MinValue), MaxValue); });
+}
+
+void UAwesomeBLArrayMath::ClampIntArrayInPlace(TArray<int32>& Values, int32 Min, int32 Max)
+{
+	const VectorRegister4Int MinValue = VectorIntSet1(Min);
+	const VectorRegister4Int MaxValue = VectorIntSet1(Max);
+	AwesomeBLArrayMath::Transform(Values.GetData(), Values.GetData(), Values.Num(), [MinValue, MaxValue](const VectorRegister4Int& Value) { return VectorIntMin(VectorIntMax(Value, MinValue), MaxValue); });
+}
+
+void UAwesomeBLArrayMath::ClampVectorArray(const TArray<FVector>& Source, FVector Min, FVector Max, TArray<FVector>& Target)
+{
+	using namespace AwesomeBLArrayMath;
+
+	ResizeUninitialized(Target, Source.Num());
+	const FVectorPattern MinPattern(Min);
+	const FVectorPattern MaxPattern(Max);
+	TransformVectors(GetComponents(Source), GetComponents(Target), Source.Num(), [&MinPattern, &MaxPattern](const VectorRegister4Double& Value, int32 Phase)
+		{
+			return VectorMin(VectorMax(Value, MinPattern.Phases[Phase]), MaxPattern.Phases[Phase]);
+		});
+}
+
+void UAwesomeBLArrayMath::ClampVectorArrayInPlace(TArray<FVector>& Values, FVector Min, FVector Max)
+{
+	using namespace AwesomeBLArrayMath;
+
+	const FVectorPattern MinPattern(Min);
+	const FVectorPattern MaxPattern(Max);
+	TransformVectors(GetComponents(Values), GetComponents(Values), Values.Num(), [&MinPattern, &MaxPattern](const VectorRegister4Double& Value, int32 Phase)
+		{
+			return VectorMin(VectorMax(Value, MinPattern.Phases[Phase]), MaxPattern.Phases[Phase]);
+		});
+}
+
+void UAwesomeBLArrayMath::LerpFloatArrays(const TArray<float>& A, const TArray<float>& B, float Alpha, TArray<float>& Target)
+{
+	const int32 Num = FMath::Min(A.Num(), B.Num());
+	AwesomeBLArrayMath::ResizeUninitialized(Target, Num);
+	const VectorRegister4Float AlphaValue = VectorSetFloat1(Alpha);
+	AwesomeBLArrayMath::Transform(A.GetData(), B.GetData(), Target.GetData(), Num, [AlphaValue](const VectorRegister4Float& From, const VectorRegister4Float& To)
+		{
+			return VectorMultiplyAdd(VectorSubtract(To, From), AlphaValue, From);
+		});
+}
+
+void UAwesomeBLArrayMath::LerpFloatArraysInPlace(TArray<float>& A, const TArray<float>& B, float Alpha)
+{
+	const int32 Num = FMath::Min(A.Num(), B.Num());
+	const VectorRegister4Float AlphaValue = VectorSetFloat1(Alpha);
+	AwesomeBLArrayMath::Transform(A.GetData(), B.GetData(), A.GetData(), Num, [AlphaValue](const VectorRegister4Float& From, const VectorRegister4Float& To)
+		{
+			return VectorMultiplyAdd(VectorSubtract(To, From), AlphaValue, From);
+		});
+}
+
+void UAwesomeBLArrayMath::LerpVectorArrays(const TArray<FVector>& A, const TArray<FVector>& B, float Alpha, TArray<FVector>& Target)
+{
+	using namespace AwesomeBLArrayMath;
+
+	// The same alpha applies to every component, so vectors can be treated as a flat array of components.
+	const int32 Num = FMath::Min(A.Num(), B.Num());
+	ResizeUninitialized(Target, Num);
+	const VectorRegister4Double AlphaValue = SetDouble(Alpha);
+	Transform(GetComponents(A), GetComponents(B), GetComponents(Target), Num * 3, [AlphaValue](const VectorRegister4Double& From, const VectorRegister4Double& To)
+		{
+			return VectorMultiplyAdd(VectorSubtract(To, From), AlphaValue, From);
+		});
+}
+
+void UAwesomeBLArrayMath::LerpVectorArraysInPlace(TArray<FVector>& A, const TArray<FVector>& B, float Alpha)
+{
+	using namespace AwesomeBLArrayMath;
+
+	const int32 Num = FMath::Min(A.Num(), B.Num());
+	const VectorRegister4Double AlphaValue = SetDouble(Alpha);
+	Transform(GetComponents(A), GetComponents(B), GetComponents(A), Num * 3, [AlphaValue](const VectorRegister4Double& From, const VectorRegister4Double& To)
+		{
+			return VectorMultiplyAdd(VectorSubtract(To, From), AlphaValue, From);
+		});
+}
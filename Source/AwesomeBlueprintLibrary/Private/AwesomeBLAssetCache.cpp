@@ -0,0 +1,262 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLAssetCache.h"
+
+#include "Containers/Ticker.h"
+#include "Engine/Engine.h"
+
+static TAutoConsoleVariable<bool> CVarAwesomeBLAssetCacheEnabled(
+	TEXT("AwesomeBL.AssetCache.Enabled"),
+	false,
+	TEXT("Keep assets loaded through the Awesome Blueprint Library soft object loaders resident within AwesomeBL.AssetCache.BudgetMB."));
+
+static TAutoConsoleVariable<int32> CVarAwesomeBLAssetCacheBudgetMB(
+	TEXT("AwesomeBL.AssetCache.BudgetMB"),
+	256,
+	TEXT("Memory budget of the asset cache in megabytes, pinned assets count against it but are never evicted."));
+
+static TAutoConsoleVariable<int32> CVarAwesomeBLAssetCacheEvictionPolicy(
+	TEXT("AwesomeBL.AssetCache.EvictionPolicy"),
+	0,
+	TEXT("How the asset cache picks what to evict. 0: least recently used, 1: size weighted, largest cold assets first."));
+
+namespace AwesomeBLAssetCache
+{
+	/** Assets with an unknown size still count against the budget so the cache can't grow without bounds */
+	constexpr int64 MinAssetBytes = 1024;
+
+	/** Evict down to this fraction of the budget so a full cache doesn't evict on every add */
+	constexpr double EvictionTarget = 0.9;
+
+	/** Least recently used assets the size weighted policy picks the largest from */
+	constexpr int32 SizeWeightedWindow = 16;
+
+	int64 GetBudgetBytes()
+	{
+		return static_cast<int64>(FMath::Max(CVarAwesomeBLAssetCacheBudgetMB.GetValueOnGameThread(), 0)) * 1024 * 1024;
+	}
+}
+
+UAwesomeBLAssetCache* UAwesomeBLAssetCache::GetIfEnabled()
+{
+	if (GEngine && CVarAwesomeBLAssetCacheEnabled.GetValueOnGameThread())
+	{
+		return GEngine->GetEngineSubsystem<UAwesomeBLAssetCache>();
+	}
+	return nullptr;
+}
+
+bool UAwesomeBLAssetCache::TryUseAssets(TConstArrayView<FSoftObjectPath> Paths)
+{
+	check(IsInGameThread());
+
+	if (Paths.IsEmpty())
+	{
+		return false;
+	}
+
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		const FCachedAsset* CachedAsset = CachedAssets.Find(Path);
+		if (!CachedAsset || !CachedAsset->Asset)
+		{
+			++NumMisses;
+			return false;
+		}
+	}
+
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		Touch(CachedAssets.FindChecked(Path));
+	}
+	++NumHits;
+	return true;
+}
+
+void UAwesomeBLAssetCache::ExecuteNextTick(FStreamableDelegate&& OnLoad)
+{
+	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([OnLoad = MoveTemp(OnLoad)](float)
+		{
+			OnLoad.ExecuteIfBound();
+			return false;
+		}));
+}
+
+void UAwesomeBLAssetCache::AddAsset(const FSoftObjectPath& Path, UObject* Asset)
+{
+	check(IsInGameThread());
+
+	if (!Asset || Path.IsNull())
+	{
+		return;
+	}
+
+	FCachedAsset& CachedAsset = CachedAssets.FindOrAdd(Path);
+	if (!CachedAsset.UseNode)
+	{
+		CachedAsset.UseNode = new FUseOrder::TDoubleLinkedListNode(Path);
+		UseOrder.AddHead(CachedAsset.UseNode);
+	}
+	if (CachedAsset.Asset != Asset)
+	{
+		CachedBytes -= CachedAsset.Bytes;
+		CachedAsset.Asset = Asset;
+		CachedAsset.Bytes = FMath::Max<int64>(Asset->GetResourceSizeBytes(EResourceSizeMode::Exclusive), AwesomeBLAssetCache::MinAssetBytes);
+		CachedBytes += CachedAsset.Bytes;
+	}
+	Touch(CachedAsset);
+
+	EvictOverBudget();
+}
+
+bool UAwesomeBLAssetCache::PinAsset(TSoftObjectPtr<UObject> Asset)
+{
+	UObject* LoadedAsset = Asset.Get();
+	if (!LoadedAsset)
+	{
+		return false;
+	}
+
+	AddAsset(Asset.ToSoftObjectPath(), LoadedAsset);
+	CachedAssets.FindChecked(Asset.ToSoftObjectPath()).bPinned = true;
+	return true;
+}
+
+void UAwesomeBLAssetCache::UnpinAsset(TSoftObjectPtr<UObject> Asset)
+{
+	if (FCachedAsset* CachedAsset = CachedAssets.Find(Asset.ToSoftObjectPath()))
+	{
+		CachedAsset->bPinned = false;
+		EvictOverBudget();
+	}
+}
+
+bool UAwesomeBLAssetCache::IsAssetCached(TSoftObjectPtr<UObject> Asset) const
+{
+	const FCachedAsset* CachedAsset = CachedAssets.Find(Asset.ToSoftObjectPath());
+	return CachedAsset && CachedAsset->Asset;
+}
+
+void UAwesomeBLAssetCache::ClearCache(bool bKeepPinned)
+{
+	for (auto It = CachedAssets.CreateIterator(); It; ++It)
+	{
+		if (!bKeepPinned || !It.Value().bPinned)
+		{
+			CachedBytes -= It.Value().Bytes;
+			UseOrder.RemoveNode(It.Value().UseNode);
+			It.RemoveCurrent();
+		}
+	}
+}
+
+FAwesomeBLAssetCacheStats UAwesomeBLAssetCache::GetStats() const
+{
+	FAwesomeBLAssetCacheStats Stats;
+	Stats.NumHits = NumHits;
+	Stats.NumMisses = NumMisses;
+	Stats.NumEvictions = NumEvictions;
+	Stats.NumAssets = CachedAssets.Num();
+	for (const TPair<FSoftObjectPath, FCachedAsset>& Pair : CachedAssets)
+	{
+		Stats.NumPinnedAssets += Pair.Value.bPinned ? 1 : 0;
+	}
+	Stats.CachedBytes = CachedBytes;
+	Stats.BudgetBytes = AwesomeBLAssetCache::GetBudgetBytes();
+	return Stats;
+}
+
+void UAwesomeBLAssetCache::ResetStats()
+{
+	NumHits = 0;
+	NumMisses = 0;
+	NumEvictions = 0;
+}
+
+void UAwesomeBLAssetCache::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	UAwesomeBLAssetCache* This = CastChecked<UAwesomeBLAssetCache>(InThis);
+	for (TPair<FSoftObjectPath, FCachedAsset>& Pair : This->CachedAssets)
+	{
+		Collector.AddReferencedObject(Pair.Value.Asset, This);
+	}
+
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+void UAwesomeBLAssetCache::Deinitialize()
+{
+	ClearCache(false);
+	Super::Deinitialize();
+}
+
+void UAwesomeBLAssetCache::Touch(FCachedAsset& CachedAsset)
+{
+	CachedAsset.LastUsedFrame = GFrameCounter;
+	if (CachedAsset.UseNode && CachedAsset.UseNode != UseOrder.GetHead())
+	{
+		UseOrder.RemoveNode(CachedAsset.UseNode, false);
+		UseOrder.AddHead(CachedAsset.UseNode);
+	}
+}
+
+void UAwesomeBLAssetCache::RemoveEntry(const FSoftObjectPath& Path)
+{
+	FCachedAsset CachedAsset;
+	if (CachedAssets.RemoveAndCopyValue(Path, CachedAsset))
+	{
+		CachedBytes -= CachedAsset.Bytes;
+		UseOrder.RemoveNode(CachedAsset.UseNode);
+	}
+}
+
+void UAwesomeBLAssetCache::EvictOverBudget()
+{
+	const int64 BudgetBytes = AwesomeBLAssetCache::GetBudgetBytes();
+	if (CachedBytes <= BudgetBytes)
+	{
+		return;
+	}
+
+	const bool bSizeWeighted = CVarAwesomeBLAssetCacheEvictionPolicy.GetValueOnGameThread() == static_cast<int32>(EAwesomeBLCacheEvictionPolicy::SizeWeighted);
+	const int32 WindowSize = bSizeWeighted ? AwesomeBLAssetCache::SizeWeightedWindow : 1;
+	const int64 TargetBytes = static_cast<int64>(BudgetBytes * AwesomeBLAssetCache::EvictionTarget);
+	while (CachedBytes > TargetBytes)
+	{
+		// Pick from the least recently used entries. Assets used this frame or the last one may still be waiting on
+		// a deferred callback, the use order puts every one of those after the first one found.
+		const FSoftObjectPath* Evict = nullptr;
+		double EvictScore = -1.;
+		int32 NumCandidates = 0;
+		for (FUseOrder::TDoubleLinkedListNode* Node = UseOrder.GetTail(); Node && NumCandidates < WindowSize; Node = Node->GetPrevNode())
+		{
+			const FCachedAsset& CachedAsset = CachedAssets.FindChecked(Node->GetValue());
+			if (CachedAsset.LastUsedFrame + 1 >= GFrameCounter)
+			{
+				break;
+			}
+			if (CachedAsset.bPinned)
+			{
+				continue;
+			}
+
+			++NumCandidates;
+			const double Age = static_cast<double>(GFrameCounter - CachedAsset.LastUsedFrame);
+			if (const double Score = bSizeWeighted ? Age * CachedAsset.Bytes : Age; Score > EvictScore)
+			{
+				Evict = &Node->GetValue();
+				EvictScore = Score;
+			}
+		}
+
+		if (!Evict)
+		{
+			break;
+		}
+
+		// Removing the entry frees its node, which owns the path.
+		RemoveEntry(FSoftObjectPath(*Evict));
+		++NumEvictions;
+	}
+}
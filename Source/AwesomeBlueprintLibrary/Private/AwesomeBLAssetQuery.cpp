@@ -0,0 +1,343 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLAssetQuery.h"
+
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/Async.h"
+#include "AwesomeBLAssetSnapshot.h"
+#include "AwesomeBLModule.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "Misc/CoreDelegates.h"
+
+namespace AwesomeBLAssetQuery
+{
+	/** Longer registry tag values are exported structs or text, not something to filter on */
+	constexpr int32 MaxIndexedValueLength = 128;
+
+	/** Seconds the asset registry has to stay unchanged before the index is rebuilt */
+	constexpr float RebuildDelay = 1.f;
+
+	/** Keep the candidates that are also in List. Both are sorted, so every lookup starts where the last one ended */
+	void Intersect(TArray<int32>& Candidates, TConstArrayView<int32> List)
+	{
+		int32 NumKept = 0;
+		int32 Cursor = 0;
+		for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num() && Cursor < List.Num(); ++CandidateIndex)
+		{
+			const int32 Candidate = Candidates[CandidateIndex];
+			Cursor += Algo::LowerBound(List.Slice(Cursor, List.Num() - Cursor), Candidate);
+			if (Cursor < List.Num() && List[Cursor] == Candidate)
+			{
+				Candidates[NumKept++] = Candidate;
+			}
+		}
+		Candidates.SetNum(NumKept, false);
+	}
+}
+
+UAwesomeBLAssetQuerySubsystem* UAwesomeBLAssetQuerySubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UAwesomeBLAssetQuerySubsystem>() : nullptr;
+}
+
+void UAwesomeBLAssetQuerySubsystem::RebuildIndex()
+{
+	check(IsInGameThread());
+
+	const UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+	TSharedPtr<const FIndex> NewIndex;
+	if (AssetManager && AssetManager->HasInitialScanCompleted())
+	{
+		NewIndex = BuildIndexFromAssetManager();
+	}
+	else if (FAwesomeBLAssetSnapshot::Get().Validate())
+	{
+		NewIndex = BuildIndexFromSnapshot();
+	}
+	else
+	{
+		return;
+	}
+	Index = NewIndex;
+
+	for (FPendingQuery& PendingQuery : PendingQueries)
+	{
+		LaunchQuery(NewIndex.ToSharedRef(), MoveTemp(PendingQuery.Query), MoveTemp(PendingQuery.OnComplete));
+	}
+	PendingQueries.Empty();
+}
+
+TArray<FPrimaryAssetId> UAwesomeBLAssetQuerySubsystem::RunQuery(const FAwesomeBLAssetQuery& Query) const
+{
+	return Index.IsValid() ? Index->Run(Query) : TArray<FPrimaryAssetId>();
+}
+
+TArray<FAwesomeBLAssetQueryResult> UAwesomeBLAssetQuerySubsystem::RunQueries(const TArray<FAwesomeBLAssetQuery>& Queries) const
+{
+	TArray<FAwesomeBLAssetQueryResult> Results;
+	Results.SetNum(Queries.Num());
+	if (Index.IsValid())
+	{
+		for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+		{
+			Results[QueryIndex].PrimaryAssetIds = Index->Run(Queries[QueryIndex]);
+		}
+	}
+	return Results;
+}
+
+void UAwesomeBLAssetQuerySubsystem::RunQueryAsync(const FAwesomeBLAssetQuery& Query, const FOnAwesomeBLAssetQueryComplete& OnComplete)
+{
+	RunQueryAsync(Query, [OnComplete](TArray<FPrimaryAssetId>&& PrimaryAssetIds)
+		{
+			OnComplete.ExecuteIfBound(PrimaryAssetIds);
+		});
+}
+
+void UAwesomeBLAssetQuerySubsystem::RunQueryAsync(const FAwesomeBLAssetQuery& Query, FOnQueryComplete&& OnComplete)
+{
+	check(IsInGameThread());
+
+	if (Index.IsValid())
+	{
+		LaunchQuery(Index.ToSharedRef(), FAwesomeBLAssetQuery(Query), MoveTemp(OnComplete));
+	}
+	else
+	{
+		PendingQueries.Add({ Query, MoveTemp(OnComplete) });
+	}
+}
+
+void UAwesomeBLAssetQuerySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Answer from the snapshot until the asset manager has scanned.
+	if (FAwesomeBLAssetSnapshot::Get().Validate())
+	{
+		RebuildIndex();
+	}
+
+	// The asset manager is usually created after engine subsystems, wait for it before waiting for its scan.
+	if (UAssetManager* AssetManager = UAssetManager::GetIfInitialized())
+	{
+		AssetManager->CallOrRegister_OnCompletedInitialScan(FSimpleMulticastDelegate::FDelegate::CreateUObject(this, &UAwesomeBLAssetQuerySubsystem::RebuildIndex));
+	}
+	else
+	{
+		FCoreDelegates::OnPostEngineInit.AddWeakLambda(this, [this]()
+			{
+				if (UAssetManager* AssetManager = UAssetManager::GetIfInitialized())
+				{
+					AssetManager->CallOrRegister_OnCompletedInitialScan(FSimpleMulticastDelegate::FDelegate::CreateUObject(this, &UAwesomeBLAssetQuerySubsystem::RebuildIndex));
+				}
+			});
+	}
+
+	if (IAssetRegistry* AssetRegistry = IAssetRegistry::Get())
+	{
+		AssetRegistry->OnAssetAdded().AddWeakLambda(this, [this](const FAssetData&) { OnAssetRegistryChanged(); });
+		AssetRegistry->OnAssetRemoved().AddWeakLambda(this, [this](const FAssetData&) { OnAssetRegistryChanged(); });
+		AssetRegistry->OnAssetRenamed().AddWeakLambda(this, [this](const FAssetData&, const FString&) { OnAssetRegistryChanged(); });
+	}
+}
+
+void UAwesomeBLAssetQuerySubsystem::Deinitialize()
+{
+	FCoreDelegates::OnPostEngineInit.RemoveAll(this);
+	if (IAssetRegistry* AssetRegistry = IAssetRegistry::Get())
+	{
+		AssetRegistry->OnAssetAdded().RemoveAll(this);
+		AssetRegistry->OnAssetRemoved().RemoveAll(this);
+		AssetRegistry->OnAssetRenamed().RemoveAll(this);
+	}
+	FTSTicker::GetCoreTicker().RemoveTicker(RebuildTickerHandle);
+	RebuildTickerHandle.Reset();
+	Index.Reset();
+	PendingQueries.Empty();
+
+	Super::Deinitialize();
+}
+
+TSharedRef<const UAwesomeBLAssetQuerySubsystem::FIndex> UAwesomeBLAssetQuerySubsystem::BuildIndexFromAssetManager()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UAwesomeBLAssetQuerySubsystem::BuildIndexFromAssetManager);
+	const double StartTime = FPlatformTime::Seconds();
+
+	const TSharedRef<FIndex> NewIndex = MakeShared<FIndex>();
+	const UAssetManager& AssetManager = UAssetManager::Get();
+
+	TArray<FPrimaryAssetTypeInfo> TypeInfos;
+	AssetManager.GetPrimaryAssetTypeInfoList(TypeInfos);
+
+	TArray<FAssetData> AssetDatas;
+	for (const FPrimaryAssetTypeInfo& TypeInfo : TypeInfos)
+	{
+		AssetDatas.Reset();
+		AssetManager.GetPrimaryAssetDataList(TypeInfo.PrimaryAssetType, AssetDatas);
+		for (const FAssetData& AssetData : AssetDatas)
+		{
+			const FPrimaryAssetId PrimaryAssetId = AssetManager.GetPrimaryAssetIdForData(AssetData);
+			if (PrimaryAssetId.IsValid())
+			{
+				NewIndex->Add(PrimaryAssetId, AssetData);
+			}
+		}
+	}
+
+	UE_LOG(LogAwesomeBL, Log, TEXT("Indexed %d primary assets, %d gameplay tags and %d registry tag values in %.2f ms"),
+		NewIndex->PrimaryAssetIds.Num(), NewIndex->ByGameplayTag.Num(), NewIndex->ByRegistryTag.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.);
+	return NewIndex;
+}
+
+TSharedRef<const UAwesomeBLAssetQuerySubsystem::FIndex> UAwesomeBLAssetQuerySubsystem::BuildIndexFromSnapshot()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UAwesomeBLAssetQuerySubsystem::BuildIndexFromSnapshot);
+	const double StartTime = FPlatformTime::Seconds();
+
+	const TSharedRef<FIndex> NewIndex = MakeShared<FIndex>();
+	FAwesomeBLAssetSnapshot::Get().ForEachPrimaryAsset([&NewIndex](const FPrimaryAssetId& PrimaryAssetId, const FAssetData& AssetData)
+		{
+			NewIndex->Add(PrimaryAssetId, AssetData);
+		});
+
+	UE_LOG(LogAwesomeBL, Log, TEXT("Indexed %d primary assets from the snapshot in %.2f ms"), NewIndex->PrimaryAssetIds.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.);
+	return NewIndex;
+}
+
+void UAwesomeBLAssetQuerySubsystem::LaunchQuery(const TSharedRef<const FIndex>& QueryIndex, FAwesomeBLAssetQuery&& Query, FOnQueryComplete&& OnComplete)
+{
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [QueryIndex, Query = MoveTemp(Query), OnComplete = MoveTemp(OnComplete)]() mutable
+		{
+			TArray<FPrimaryAssetId> PrimaryAssetIds = QueryIndex->Run(Query);
+			AsyncTask(ENamedThreads::GameThread, [PrimaryAssetIds = MoveTemp(PrimaryAssetIds), OnComplete = MoveTemp(OnComplete)]() mutable
+				{
+					OnComplete(MoveTemp(PrimaryAssetIds));
+				});
+		});
+}
+
+void UAwesomeBLAssetQuerySubsystem::OnAssetRegistryChanged()
+{
+	// Changes during the initial scan are covered by the rebuild once it completes.
+	const UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+	if (!AssetManager || !AssetManager->HasInitialScanCompleted())
+	{
+		return;
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(RebuildTickerHandle);
+	RebuildTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
+		{
+			RebuildTickerHandle.Reset();
+			RebuildIndex();
+			return false;
+		}), AwesomeBLAssetQuery::RebuildDelay);
+}
+
+void UAwesomeBLAssetQuerySubsystem::FIndex::Add(const FPrimaryAssetId& PrimaryAssetId, const FAssetData& AssetData)
+{
+	// Indices are handed out in increasing order, so every posting list is sorted as it is built.
+	const int32 AssetIndex = PrimaryAssetIds.Add(PrimaryAssetId);
+	ByType.FindOrAdd(PrimaryAssetId.PrimaryAssetType).Add(AssetIndex);
+
+	AssetData.TagsAndValues.ForEach([this, AssetIndex](const TPair<FName, FAssetTagValueRef>& Pair)
+		{
+			const FString Value = Pair.Value.AsString();
+			if (Value.StartsWith(TEXT("(GameplayTags=")))
+			{
+				FGameplayTagContainer Tags;
+				Tags.FromExportString(Value);
+				for (const FGameplayTag& Tag : Tags.GetGameplayTagParents())
+				{
+					TArray<int32>& List = ByGameplayTag.FindOrAdd(Tag);
+					if (List.IsEmpty() || List.Last() != AssetIndex)
+					{
+						List.Add(AssetIndex);
+					}
+				}
+			}
+			else if (Value.Len() <= AwesomeBLAssetQuery::MaxIndexedValueLength)
+			{
+				ByRegistryTag.FindOrAdd({ Pair.Key, Value }).Add(AssetIndex);
+			}
+		});
+}
+
+TArray<FPrimaryAssetId> UAwesomeBLAssetQuerySubsystem::FIndex::Run(const FAwesomeBLAssetQuery& Query) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UAwesomeBLAssetQuerySubsystem::RunQuery);
+
+	// Lists that all have to match. Several types are merged into one list since any of them matches.
+	TArray<TConstArrayView<int32>, TInlineAllocator<8>> Lists;
+	TArray<int32> TypeList;
+	if (Query.Types.Num() == 1)
+	{
+		const TArray<int32>* List = ByType.Find(Query.Types[0]);
+		if (!List)
+		{
+			return {};
+		}
+		Lists.Add(*List);
+	}
+	else if (Query.Types.Num() > 1)
+	{
+		for (const FPrimaryAssetType& Type : Query.Types)
+		{
+			if (const TArray<int32>* List = ByType.Find(Type))
+			{
+				TypeList.Append(*List);
+			}
+		}
+		if (TypeList.IsEmpty())
+		{
+			return {};
+		}
+		Algo::Sort(TypeList);
+		Lists.Add(TypeList);
+	}
+
+	for (const FGameplayTag& Tag : Query.RequiredTags)
+	{
+		const TArray<int32>* List = ByGameplayTag.Find(Tag);
+		if (!List)
+		{
+			return {};
+		}
+		Lists.Add(*List);
+	}
+
+	for (const TPair<FName, FString>& RegistryTag : Query.RequiredRegistryTags)
+	{
+		const TArray<int32>* List = ByRegistryTag.Find({ RegistryTag.Key, RegistryTag.Value });
+		if (!List)
+		{
+			return {};
+		}
+		Lists.Add(*List);
+	}
+
+	if (Lists.IsEmpty())
+	{
+		return PrimaryAssetIds;
+	}
+
+	Lists.Sort([](const TConstArrayView<int32>& A, const TConstArrayView<int32>& B) { return A.Num() < B.Num(); });
+	TArray<int32> Candidates(Lists[0]);
+	for (int32 ListIndex = 1; ListIndex < Lists.Num() && !Candidates.IsEmpty(); ++ListIndex)
+	{
+		AwesomeBLAssetQuery::Intersect(Candidates, Lists[ListIndex]);
+	}
+
+	TArray<FPrimaryAssetId> Result;
+	Result.Reserve(Candidates.Num());
+	for (const int32 Candidate : Candidates)
+	{
+		Result.Add(PrimaryAssetIds[Candidate]);
+	}
+	return Result;
+}
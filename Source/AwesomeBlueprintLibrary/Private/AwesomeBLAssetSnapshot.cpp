@@ -0,0 +1,422 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLAssetSnapshot.h"
+
+#include "Algo/BinarySearch.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AwesomeBLModule.h"
+#include "Engine/AssetManager.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+
+namespace AwesomeBLAssetSnapshot
+{
+	FUtf8StringView ToKey(const FPrimaryAssetId& PrimaryAssetId, TUtf8StringBuilder<256>& Builder)
+	{
+		Builder << PrimaryAssetId.PrimaryAssetType.GetName() << ':' << PrimaryAssetId.PrimaryAssetName;
+		return Builder.ToView();
+	}
+
+	bool KeyLess(FUtf8StringView A, FUtf8StringView B)
+	{
+		return A.Compare(B, ESearchCase::IgnoreCase) < 0;
+	}
+}
+
+FAwesomeBLAssetSnapshot& FAwesomeBLAssetSnapshot::Get()
+{
+	static FAwesomeBLAssetSnapshot Snapshot;
+	return Snapshot;
+}
+
+FAwesomeBLAssetSnapshot::~FAwesomeBLAssetSnapshot()
+{
+	Close();
+}
+
+FString FAwesomeBLAssetSnapshot::GetDefaultFilename()
+{
+	return FPaths::ProjectContentDir() / TEXT("AwesomeBL/PrimaryAssetIndex.bin");
+}
+
+bool FAwesomeBLAssetSnapshot::Open(const FString& Filename)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAwesomeBLAssetSnapshot::Open);
+	Close();
+
+	MappedHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (!MappedHandle || MappedHandle->GetFileSize() < static_cast<int64>(sizeof(FHeader)))
+	{
+		Close();
+		return false;
+	}
+	MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+	if (!MappedRegion)
+	{
+		Close();
+		return false;
+	}
+
+	const uint8* Data = MappedRegion->GetMappedPtr();
+	const int64 Size = MappedRegion->GetMappedSize();
+	const FHeader* MappedHeader = reinterpret_cast<const FHeader*>(Data);
+	if (MappedHeader->Magic != Magic || MappedHeader->FormatVersion != FormatVersion || MappedHeader->BuildHash != ComputeBuildHash())
+	{
+		UE_LOG(LogAwesomeBL, Log, TEXT("Ignoring primary asset snapshot %s, it was written by another build"), *Filename);
+		Close();
+		return false;
+	}
+
+	const int64 EntriesOffset = sizeof(FHeader);
+	const int64 TagsOffset = EntriesOffset + static_cast<int64>(MappedHeader->NumEntries) * sizeof(FEntry);
+	const int64 StringsOffset = TagsOffset + static_cast<int64>(MappedHeader->NumTags) * sizeof(FTag);
+	if (StringsOffset + MappedHeader->StringsSize != Size)
+	{
+		UE_LOG(LogAwesomeBL, Warning, TEXT("Ignoring primary asset snapshot %s, it is truncated"), *Filename);
+		Close();
+		return false;
+	}
+
+	Header = MappedHeader;
+	Entries = MakeArrayView(reinterpret_cast<const FEntry*>(Data + EntriesOffset), Header->NumEntries);
+	Tags = MakeArrayView(reinterpret_cast<const FTag*>(Data + TagsOffset), Header->NumTags);
+	Strings = reinterpret_cast<const UTF8CHAR*>(Data + StringsOffset);
+	bValidated = false;
+
+	if (!AreOffsetsValid())
+	{
+		UE_LOG(LogAwesomeBL, Warning, TEXT("Ignoring primary asset snapshot %s, it is corrupt"), *Filename);
+		Close();
+		return false;
+	}
+
+	if (!Validate())
+	{
+		return false;
+	}
+
+	// The asset manager doesn't exist yet when this is opened at module startup.
+	if (UAssetManager::GetIfInitialized())
+	{
+		RegisterInitialScanCallback();
+	}
+	else if (!PostEngineInitHandle.IsValid())
+	{
+		PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddRaw(this, &FAwesomeBLAssetSnapshot::RegisterInitialScanCallback);
+	}
+
+	UE_LOG(LogAwesomeBL, Log, TEXT("Mapped primary asset snapshot %s with %d primary assets"), *Filename, Entries.Num());
+	return true;
+}
+
+void FAwesomeBLAssetSnapshot::Close()
+{
+	Header = nullptr;
+	Entries = {};
+	Tags = {};
+	Strings = nullptr;
+	bValidated = false;
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+}
+
+int32 FAwesomeBLAssetSnapshot::Num() const
+{
+	return Entries.Num();
+}
+
+bool FAwesomeBLAssetSnapshot::Validate()
+{
+	if (!IsOpen() || bValidated)
+	{
+		return IsOpen();
+	}
+
+	// Until the registry has loaded, a missing asset may just not have been found yet.
+	const IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+	if (!AssetRegistry || AssetRegistry->IsLoadingAssets())
+	{
+		return true;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAwesomeBLAssetSnapshot::Validate);
+	bValidated = true;
+	for (const FEntry& Entry : Entries)
+	{
+		const FSoftObjectPath ObjectPath(FTopLevelAssetPath(FName(GetString(Entry.PackageName)), FName(GetString(Entry.AssetName))), FString());
+		if (!AssetRegistry->GetAssetByObjectPath(ObjectPath, true).IsValid())
+		{
+			UE_LOG(LogAwesomeBL, Warning, TEXT("Ignoring primary asset snapshot, %s no longer exists. Run the AwesomeBLPrimaryAssetIndex commandlet to update it."), *ObjectPath.ToString());
+			Close();
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FAwesomeBLAssetSnapshot::GetPrimaryAssetData(const FPrimaryAssetId& PrimaryAssetId, FAssetData& OutAssetData)
+{
+	if (!Validate() || !PrimaryAssetId.IsValid())
+	{
+		return false;
+	}
+
+	TUtf8StringBuilder<256> Builder;
+	const FUtf8StringView Key = AwesomeBLAssetSnapshot::ToKey(PrimaryAssetId, Builder);
+	const int32 Index = Algo::LowerBoundBy(Entries, Key, [this](const FEntry& Entry) { return GetString(Entry.Key); }, &AwesomeBLAssetSnapshot::KeyLess);
+	if (!Entries.IsValidIndex(Index) || !GetString(Entries[Index].Key).Equals(Key, ESearchCase::IgnoreCase))
+	{
+		return false;
+	}
+
+	OutAssetData = MakeAssetData(Entries[Index]);
+	return true;
+}
+
+void FAwesomeBLAssetSnapshot::ForEachPrimaryAsset(TFunctionRef<void(const FPrimaryAssetId&, const FAssetData&)> Function)
+{
+	if (!Validate())
+	{
+		return;
+	}
+
+	for (const FEntry& Entry : Entries)
+	{
+		Function(MakePrimaryAssetId(Entry), MakeAssetData(Entry));
+	}
+}
+
+uint32 FAwesomeBLAssetSnapshot::GetContentHash() const
+{
+	return Header ? Header->ContentHash : 0;
+}
+
+uint32 FAwesomeBLAssetSnapshot::ComputeContentHash(TConstArrayView<FPrimaryAssetId> PrimaryAssetIds)
+{
+	// FName hashes change between runs, hash the text. Summing keeps the hash independent of order.
+	uint32 Hash = 0;
+	for (const FPrimaryAssetId& PrimaryAssetId : PrimaryAssetIds)
+	{
+		Hash += FCrc::StrCrc32(*PrimaryAssetId.ToString().ToLower());
+	}
+	return Hash;
+}
+
+uint32 FAwesomeBLAssetSnapshot::ComputeBuildHash()
+{
+	// The changelist is 0 on most source builds, the build version tells those apart.
+	return FCrc::StrCrc32(*FString::Printf(TEXT("%s-%u-%s"), FApp::GetProjectName(), FEngineVersion::CompatibleWith().GetChangelist(), FApp::GetBuildVersion()));
+}
+
+bool FAwesomeBLAssetSnapshot::AreOffsetsValid() const
+{
+	const uint64 StringsSize = Header->StringsSize;
+	auto IsStringValid = [StringsSize](const FStringRef& Ref)
+		{
+			return static_cast<uint64>(Ref.Offset) + Ref.Len <= StringsSize;
+		};
+
+	for (const FEntry& Entry : Entries)
+	{
+		if (!IsStringValid(Entry.Key) || !IsStringValid(Entry.PackageName) || !IsStringValid(Entry.AssetName) || !IsStringValid(Entry.ClassPath)
+			|| static_cast<uint64>(Entry.FirstTag) + Entry.NumTags > static_cast<uint64>(Tags.Num()))
+		{
+			return false;
+		}
+
+		int32 Separator = INDEX_NONE;
+		if (!GetString(Entry.Key).FindChar(':', Separator))
+		{
+			return false;
+		}
+	}
+
+	for (const FTag& Tag : Tags)
+	{
+		if (!IsStringValid(Tag.Key) || !IsStringValid(Tag.Value))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FUtf8StringView FAwesomeBLAssetSnapshot::GetString(const FStringRef& Ref) const
+{
+	return FUtf8StringView(Strings + Ref.Offset, Ref.Len);
+}
+
+FPrimaryAssetId FAwesomeBLAssetSnapshot::MakePrimaryAssetId(const FEntry& Entry) const
+{
+	const FUtf8StringView Key = GetString(Entry.Key);
+	int32 Separator = INDEX_NONE;
+	Key.FindChar(':', Separator);
+	return FPrimaryAssetId(FPrimaryAssetType(FName(Key.Left(Separator))), FName(Key.RightChop(Separator + 1)));
+}
+
+FAssetData FAwesomeBLAssetSnapshot::MakeAssetData(const FEntry& Entry) const
+{
+	FAssetDataTagMap TagMap;
+	TagMap.Reserve(Entry.NumTags);
+	for (const FTag& Tag : Tags.Slice(Entry.FirstTag, Entry.NumTags))
+	{
+		TagMap.Add(FName(GetString(Tag.Key)), FString(GetString(Tag.Value)));
+	}
+
+	const FName PackageName(GetString(Entry.PackageName));
+	return FAssetData(PackageName, FName(FPackageName::GetLongPackagePath(PackageName.ToString())), FName(GetString(Entry.AssetName)),
+		FTopLevelAssetPath(FString(GetString(Entry.ClassPath))), MoveTemp(TagMap));
+}
+
+void FAwesomeBLAssetSnapshot::RegisterInitialScanCallback()
+{
+	if (UAssetManager* AssetManager = UAssetManager::GetIfInitialized())
+	{
+		AssetManager->CallOrRegister_OnCompletedInitialScan(FSimpleMulticastDelegate::FDelegate::CreateRaw(this, &FAwesomeBLAssetSnapshot::OnCompletedInitialScan));
+	}
+}
+
+void FAwesomeBLAssetSnapshot::OnCompletedInitialScan()
+{
+	if (!IsOpen())
+	{
+		return;
+	}
+
+	const UAssetManager& AssetManager = UAssetManager::Get();
+	TArray<FPrimaryAssetTypeInfo> TypeInfos;
+	AssetManager.GetPrimaryAssetTypeInfoList(TypeInfos);
+
+	TArray<FPrimaryAssetId> PrimaryAssetIds;
+	for (const FPrimaryAssetTypeInfo& TypeInfo : TypeInfos)
+	{
+		AssetManager.GetPrimaryAssetIdList(TypeInfo.PrimaryAssetType, PrimaryAssetIds);
+	}
+
+	if (ComputeContentHash(PrimaryAssetIds) != GetContentHash())
+	{
+		UE_LOG(LogAwesomeBL, Warning, TEXT("Primary asset snapshot was stale, it has %d primary assets and the asset manager %d. Run the AwesomeBLPrimaryAssetIndex commandlet to update it."),
+			Entries.Num(), PrimaryAssetIds.Num());
+	}
+
+	Close();
+}
+
+#if WITH_EDITOR
+bool FAwesomeBLAssetSnapshot::Write(const FString& Filename)
+{
+	const UAssetManager& AssetManager = UAssetManager::Get();
+	TArray<FPrimaryAssetTypeInfo> TypeInfos;
+	AssetManager.GetPrimaryAssetTypeInfoList(TypeInfos);
+
+	struct FSource
+	{
+		FPrimaryAssetId PrimaryAssetId;
+		FAssetData AssetData;
+		FString Key;
+	};
+	TArray<FSource> Sources;
+	TArray<FAssetData> AssetDatas;
+	for (const FPrimaryAssetTypeInfo& TypeInfo : TypeInfos)
+	{
+		AssetDatas.Reset();
+		AssetManager.GetPrimaryAssetDataList(TypeInfo.PrimaryAssetType, AssetDatas);
+		for (FAssetData& AssetData : AssetDatas)
+		{
+			const FPrimaryAssetId PrimaryAssetId = AssetManager.GetPrimaryAssetIdForData(AssetData);
+			if (PrimaryAssetId.IsValid())
+			{
+				Sources.Add({ PrimaryAssetId, MoveTemp(AssetData), PrimaryAssetId.ToString() });
+			}
+		}
+	}
+
+	// Sort the way lookups compare, on the UTF-8 text.
+	TArray<TArray<UTF8CHAR>> Keys;
+	TArray<int32> Order;
+	Keys.Reserve(Sources.Num());
+	Order.Reserve(Sources.Num());
+	for (const FSource& Source : Sources)
+	{
+		const FTCHARToUTF8 Utf8(*Source.Key);
+		Order.Add(Keys.Emplace(reinterpret_cast<const UTF8CHAR*>(Utf8.Get()), Utf8.Length()));
+	}
+	Order.Sort([&Keys](int32 A, int32 B) { return AwesomeBLAssetSnapshot::KeyLess(FUtf8StringView(Keys[A]), FUtf8StringView(Keys[B])); });
+
+	// Tag values repeat a lot, e.g. enum values, so each distinct string is stored once.
+	struct FCaseSensitiveKeyFuncs : BaseKeyFuncs<TPair<FString, FStringRef>, FString>
+	{
+		static const FString& GetSetKey(const TPair<FString, FStringRef>& Element) { return Element.Key; }
+		static bool Matches(const FString& A, const FString& B) { return A.Equals(B, ESearchCase::CaseSensitive); }
+		static uint32 GetKeyHash(const FString& Key) { return FCrc::StrCrc32(*Key); }
+	};
+	TArray<uint8> Blob;
+	TMap<FString, FStringRef, FDefaultSetAllocator, FCaseSensitiveKeyFuncs> StringRefs;
+	auto AddString = [&Blob, &StringRefs](const FString& String)
+		{
+			if (const FStringRef* Ref = StringRefs.Find(String))
+			{
+				return *Ref;
+			}
+			const FTCHARToUTF8 Utf8(*String);
+			const FStringRef Ref{ static_cast<uint32>(Blob.Num()), static_cast<uint32>(Utf8.Length()) };
+			Blob.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+			return StringRefs.Add(String, Ref);
+		};
+
+	TArray<FEntry> Entries;
+	TArray<FTag> Tags;
+	TArray<FPrimaryAssetId> PrimaryAssetIds;
+	Entries.Reserve(Sources.Num());
+	PrimaryAssetIds.Reserve(Sources.Num());
+	for (const int32 Index : Order)
+	{
+		const FSource& Source = Sources[Index];
+		FEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.Key = AddString(Source.Key);
+		Entry.PackageName = AddString(Source.AssetData.PackageName.ToString());
+		Entry.AssetName = AddString(Source.AssetData.AssetName.ToString());
+		Entry.ClassPath = AddString(Source.AssetData.AssetClassPath.ToString());
+		Entry.FirstTag = Tags.Num();
+		Source.AssetData.TagsAndValues.ForEach([&Tags, &AddString](const TPair<FName, FAssetTagValueRef>& Pair)
+			{
+				Tags.Add({ AddString(Pair.Key.ToString()), AddString(Pair.Value.AsString()) });
+			});
+		Entry.NumTags = Tags.Num() - Entry.FirstTag;
+		PrimaryAssetIds.Add(Source.PrimaryAssetId);
+	}
+
+	FHeader FileHeader;
+	FileHeader.Magic = Magic;
+	FileHeader.FormatVersion = FormatVersion;
+	FileHeader.BuildHash = ComputeBuildHash();
+	FileHeader.ContentHash = ComputeContentHash(PrimaryAssetIds);
+	FileHeader.NumEntries = Entries.Num();
+	FileHeader.NumTags = Tags.Num();
+	FileHeader.StringsSize = Blob.Num();
+	FileHeader.Padding = 0;
+
+	TArray<uint8> Data;
+	Data.Reserve(sizeof(FHeader) + Entries.Num() * sizeof(FEntry) + Tags.Num() * sizeof(FTag) + Blob.Num());
+	Data.Append(reinterpret_cast<const uint8*>(&FileHeader), sizeof(FHeader));
+	Data.Append(reinterpret_cast<const uint8*>(Entries.GetData()), Entries.Num() * sizeof(FEntry));
+	Data.Append(reinterpret_cast<const uint8*>(Tags.GetData()), Tags.Num() * sizeof(FTag));
+	Data.Append(Blob);
+
+	if (!FFileHelper::SaveArrayToFile(Data, *Filename))
+	{
+		UE_LOG(LogAwesomeBL, Error, TEXT("Failed to write primary asset snapshot %s"), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogAwesomeBL, Display, TEXT("Wrote primary asset snapshot %s with %d primary assets, %d tags, %d bytes"), *Filename, Entries.Num(), Tags.Num(), Data.Num());
+	return true;
+}
+#endif
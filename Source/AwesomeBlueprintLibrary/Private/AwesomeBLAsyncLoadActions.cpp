@@ -0,0 +1,260 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLAsyncLoadActions.h"
+
+#include "AwesomeBL.h"
+#include "AwesomeBLLoadCoalescer.h"
+
+namespace AwesomeBLAsyncLoadActions
+{
+	/** Null and duplicate entries do not make a load fail, so only distinct requested assets are compared */
+	int32 NumRequested(const TArray<TSoftObjectPtr<UObject>>& AssetsToLoad)
+	{
+		TSet<FSoftObjectPath> Requested;
+		for (const TSoftObjectPtr<UObject>& Asset : AssetsToLoad)
+		{
+			if (!Asset.IsNull())
+			{
+				Requested.Add(Asset.ToSoftObjectPath());
+			}
+		}
+		return Requested.Num();
+	}
+
+	/** Invalid and duplicate ids do not make a load fail, so only distinct valid ids are compared */
+	int32 NumRequested(const TArray<FPrimaryAssetId>& AssetsToLoad)
+	{
+		TSet<FPrimaryAssetId> Requested;
+		for (const FPrimaryAssetId& PrimaryAssetId : AssetsToLoad)
+		{
+			if (PrimaryAssetId.IsValid())
+			{
+				Requested.Add(PrimaryAssetId);
+			}
+		}
+		return Requested.Num();
+	}
+}
+
+void UAwesomeBLAsyncLoadActionBase::Cancel()
+{
+	// The handle may be shared with merged requests, let the coalescer decide if the load can actually stop.
+	FAwesomeBLLoadCoalescer::Get().CancelRequest(Token);
+	Finish();
+}
+
+void UAwesomeBLAsyncLoadActionBase::Finish()
+{
+	bFinished = true;
+	Handle.Reset();
+	SetReadyToDestroy();
+}
+
+UAwesomeBLAsyncLoadAsset* UAwesomeBLAsyncLoadAsset::AsyncLoadAssetLatent(UObject* WorldContextObject, TSoftObjectPtr<UObject> AssetToLoad, int32 Priority)
+{
+	UAwesomeBLAsyncLoadAsset* Action = NewObject<UAwesomeBLAsyncLoadAsset>();
+	Action->AssetToLoad = MoveTemp(AssetToLoad);
+	Action->Priority = Priority;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UAwesomeBLAsyncLoadAsset::Activate()
+{
+	Handle = UAwesomeBL::TRequestAsyncLoadAsset<UObject>(AssetToLoad, TDelegate<void(UObject*)>::CreateUObject(this, &UAwesomeBLAsyncLoadAsset::HandleLoaded), Priority, &Token);
+	if (!Handle.IsValid() && !bFinished)
+	{
+		// Nothing to load, e.g. a null reference.
+		HandleLoaded(nullptr);
+	}
+	if (bFinished)
+	{
+		// Already resident, the callback ran before the handle was returned.
+		Handle.Reset();
+	}
+}
+
+void UAwesomeBLAsyncLoadAsset::HandleLoaded(UObject* LoadedAsset)
+{
+	if (bFinished)
+	{
+		return;
+	}
+
+	if (LoadedAsset)
+	{
+		OnLoaded.Broadcast(LoadedAsset);
+	}
+	else
+	{
+		OnFailed.Broadcast(nullptr);
+	}
+	Finish();
+}
+
+UAwesomeBLAsyncLoadAssets* UAwesomeBLAsyncLoadAssets::AsyncLoadAssetsLatent(UObject* WorldContextObject, const TArray<TSoftObjectPtr<UObject>>& AssetListToLoad, int32 Priority)
+{
+	UAwesomeBLAsyncLoadAssets* Action = NewObject<UAwesomeBLAsyncLoadAssets>();
+	Action->AssetListToLoad = AssetListToLoad;
+	Action->Priority = Priority;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UAwesomeBLAsyncLoadAssets::Activate()
+{
+	Handle = UAwesomeBL::TRequestAsyncLoadAssets<UObject>(AssetListToLoad, TDelegate<void(const TArray<UObject*>&)>::CreateUObject(this, &UAwesomeBLAsyncLoadAssets::HandleLoaded), Priority, &Token);
+	if (!Handle.IsValid() && !bFinished)
+	{
+		HandleLoaded({});
+	}
+	if (bFinished)
+	{
+		Handle.Reset();
+	}
+}
+
+void UAwesomeBLAsyncLoadAssets::HandleLoaded(const TArray<UObject*>& LoadedAssets)
+{
+	if (bFinished)
+	{
+		return;
+	}
+
+	// Assets that failed to load are left out of the list.
+	if (TSet<UObject*>(LoadedAssets).Num() == AwesomeBLAsyncLoadActions::NumRequested(AssetListToLoad))
+	{
+		OnLoaded.Broadcast(LoadedAssets);
+	}
+	else
+	{
+		OnFailed.Broadcast(LoadedAssets);
+	}
+	Finish();
+}
+
+UAwesomeBLAsyncLoadClass* UAwesomeBLAsyncLoadClass::AsyncLoadClassLatent(UObject* WorldContextObject, TSoftClassPtr<UObject> ClassToLoad, int32 Priority)
+{
+	UAwesomeBLAsyncLoadClass* Action = NewObject<UAwesomeBLAsyncLoadClass>();
+	Action->ClassToLoad = MoveTemp(ClassToLoad);
+	Action->Priority = Priority;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UAwesomeBLAsyncLoadClass::Activate()
+{
+	const TSoftObjectPtr<UClass> AssetToLoad(ClassToLoad.ToSoftObjectPath());
+	Handle = UAwesomeBL::TRequestAsyncLoadAsset<UClass>(AssetToLoad, TDelegate<void(UClass*)>::CreateUObject(this, &UAwesomeBLAsyncLoadClass::HandleLoaded), Priority, &Token);
+	if (!Handle.IsValid() && !bFinished)
+	{
+		HandleLoaded(nullptr);
+	}
+	if (bFinished)
+	{
+		Handle.Reset();
+	}
+}
+
+void UAwesomeBLAsyncLoadClass::HandleLoaded(UClass* LoadedClass)
+{
+	if (bFinished)
+	{
+		return;
+	}
+
+	if (LoadedClass)
+	{
+		OnLoaded.Broadcast(LoadedClass);
+	}
+	else
+	{
+		OnFailed.Broadcast(nullptr);
+	}
+	Finish();
+}
+
+UAwesomeBLAsyncLoadPrimaryAsset* UAwesomeBLAsyncLoadPrimaryAsset::AsyncLoadPrimaryAssetLatent(UObject* WorldContextObject, const FPrimaryAssetId& AssetToLoad, const TArray<FName>& LoadBundles, int32 Priority)
+{
+	UAwesomeBLAsyncLoadPrimaryAsset* Action = NewObject<UAwesomeBLAsyncLoadPrimaryAsset>();
+	Action->AssetToLoad = AssetToLoad;
+	Action->LoadBundles = LoadBundles;
+	Action->Priority = Priority;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UAwesomeBLAsyncLoadPrimaryAsset::Activate()
+{
+	Handle = UAwesomeBL::TRequestAsyncLoadPrimaryAsset<UObject>(AssetToLoad, LoadBundles, TDelegate<void(const FPrimaryAssetId&, UObject*)>::CreateUObject(this, &UAwesomeBLAsyncLoadPrimaryAsset::HandleLoaded), Priority, &Token);
+	if (!Handle.IsValid() && !bFinished)
+	{
+		// No asset manager, or nothing to load for this id.
+		HandleLoaded(AssetToLoad, nullptr);
+	}
+	if (bFinished)
+	{
+		Handle.Reset();
+	}
+}
+
+void UAwesomeBLAsyncLoadPrimaryAsset::HandleLoaded(const FPrimaryAssetId& LoadedId, UObject* LoadedAsset)
+{
+	if (bFinished)
+	{
+		return;
+	}
+
+	if (LoadedAsset)
+	{
+		OnLoaded.Broadcast(LoadedId, LoadedAsset);
+	}
+	else
+	{
+		OnFailed.Broadcast(AssetToLoad, nullptr);
+	}
+	Finish();
+}
+
+UAwesomeBLAsyncLoadPrimaryAssets* UAwesomeBLAsyncLoadPrimaryAssets::AsyncLoadPrimaryAssetsLatent(UObject* WorldContextObject, const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, int32 Priority)
+{
+	UAwesomeBLAsyncLoadPrimaryAssets* Action = NewObject<UAwesomeBLAsyncLoadPrimaryAssets>();
+	Action->AssetsToLoad = AssetsToLoad;
+	Action->LoadBundles = LoadBundles;
+	Action->Priority = Priority;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UAwesomeBLAsyncLoadPrimaryAssets::Activate()
+{
+	Handle = UAwesomeBL::TRequestAsyncLoadPrimaryAssetList<UObject>(AssetsToLoad, LoadBundles, TDelegate<void(const TArray<FPrimaryAssetId>&, const TArray<UObject*>&)>::CreateUObject(this, &UAwesomeBLAsyncLoadPrimaryAssets::HandleLoaded), Priority, &Token);
+	if (!Handle.IsValid() && !bFinished)
+	{
+		HandleLoaded({}, {});
+	}
+	if (bFinished)
+	{
+		Handle.Reset();
+	}
+}
+
+void UAwesomeBLAsyncLoadPrimaryAssets::HandleLoaded(const TArray<FPrimaryAssetId>& LoadedIds, const TArray<UObject*>& LoadedAssets)
+{
+	if (bFinished)
+	{
+		return;
+	}
+
+	// Primary assets that failed to load are left out of the lists.
+	if (TSet<FPrimaryAssetId>(LoadedIds).Num() == AwesomeBLAsyncLoadActions::NumRequested(AssetsToLoad))
+	{
+		OnLoaded.Broadcast(LoadedIds, LoadedAssets);
+	}
+	else
+	{
+		OnFailed.Broadcast(LoadedIds, LoadedAssets);
+	}
+	Finish();
+}
@@ -0,0 +1,534 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBL.h"
+#include "AwesomeBLArrayMath.h"
+#include "AwesomeBLLoadRequest.h"
+#include "AwesomeBLModule.h"
+#include "AwesomeBLNameBatch.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "Containers/Ticker.h"
+#include "HAL/MemoryBase.h"
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/DateTime.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/StrongObjectPtr.h"
+#include <atomic>
+
+/**
+ * Benchmarks of the hot functions of the library on synthetic content, written as JSON to Saved/Benchmarks so
+ * results can be compared across engine upgrades. Runs headless, e.g.
+ * -game -nullrhi -ExecCmds="AwesomeBL.RunBenchmarks Quit"
+ */
+namespace AwesomeBLBenchmarks
+{
+	/** Element counts of the Data Helpers, the other benchmarks stop at MaxObjectElements */
+	const int32 ElementCounts[] = { 10, 100, 1000, 10000, 100000, 1000000 };
+
+	/** Components and assets are real UObjects, past this the benchmark measures the garbage collector more than us */
+	constexpr int32 MaxObjectElements = 10000;
+
+	/** Number of async load samples per element count */
+	constexpr int32 NumAsyncIterations = 5;
+
+	/** Load stats are off by default, the async load cases run with them on to include their cost */
+	const TCHAR* LoadStatsCVarName = TEXT("AwesomeBL.LoadStats.Enabled");
+
+	/**
+	 * Forwards to the allocator it wraps and counts the game thread allocations made between Begin and End. Installed
+	 * as GMalloc while the benchmarks run. The counter itself is never freed, since other threads may still be inside
+	 * it after it was uninstalled.
+	 */
+	class FAllocationCounter : public FMalloc
+	{
+	public:
+
+		static FAllocationCounter& Get()
+		{
+			static FAllocationCounter* Counter = new FAllocationCounter();
+			return *Counter;
+		}
+
+		void Install()
+		{
+			if (GMalloc != this)
+			{
+				Inner = GMalloc;
+				GMalloc = this;
+			}
+		}
+
+		/** Hand GMalloc back to the wrapped allocator, unless something wrapped the counter in the meantime */
+		void Uninstall()
+		{
+			if (GMalloc == this)
+			{
+				GMalloc = Inner;
+			}
+			else
+			{
+				ensureMsgf(GMalloc == Inner, TEXT("GMalloc was replaced while the benchmarks ran, leaving the allocation counter installed"));
+			}
+		}
+
+		void Begin()
+		{
+			NumAllocations = 0;
+			bCounting = true;
+		}
+
+		int64 End()
+		{
+			bCounting = false;
+			return NumAllocations;
+		}
+
+		//~ Begin FMalloc Interface
+		virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+		{
+			Count();
+			return Inner->Malloc(Size, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override
+		{
+			if (Size > 0)
+			{
+				Count();
+			}
+			return Inner->Realloc(Original, Size, Alignment);
+		}
+
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+		//~ End FMalloc Interface
+
+	private:
+
+		FAllocationCounter() = default;
+
+		void Count()
+		{
+			if (bCounting && IsInGameThread())
+			{
+				++NumAllocations;
+			}
+		}
+
+		FMalloc* Inner = nullptr;
+		std::atomic<bool> bCounting = false;
+		int64 NumAllocations = 0;
+	};
+
+	struct FResult
+	{
+		FString Name;
+		int32 NumElements = 0;
+		int32 NumIterations = 0;
+		double MinMs = 0.;
+		double MedianMs = 0.;
+		double MeanMs = 0.;
+		int32 NumFrames = 0;
+		/** Game thread heap allocations per iteration, only the requests for async loads */
+		double NumAllocations = 0.;
+	};
+
+	/** Run enough iterations for stable numbers without spending minutes on the million element cases */
+	int32 GetNumIterations(int32 NumElements)
+	{
+		return FMath::Clamp(1000000 / NumElements, 3, 100);
+	}
+
+	FResult MakeResult(const TCHAR* Name, int32 NumElements, TArray<double>& SamplesMs, int64 NumAllocations, int32 NumFrames = 0)
+	{
+		SamplesMs.Sort();
+
+		FResult Result;
+		Result.Name = Name;
+		Result.NumElements = NumElements;
+		Result.NumIterations = SamplesMs.Num();
+		Result.MinMs = SamplesMs[0];
+		Result.MedianMs = SamplesMs[SamplesMs.Num() / 2];
+		for (const double Sample : SamplesMs)
+		{
+			Result.MeanMs += Sample / SamplesMs.Num();
+		}
+		Result.NumFrames = NumFrames;
+		Result.NumAllocations = static_cast<double>(NumAllocations) / SamplesMs.Num();
+		return Result;
+	}
+
+	template<typename FunctionType>
+	FResult Measure(const TCHAR* Name, int32 NumElements, FunctionType&& Function)
+	{
+		const int32 NumIterations = GetNumIterations(NumElements);
+
+		TArray<double> SamplesMs;
+		SamplesMs.Reserve(NumIterations);
+		int64 NumAllocations = 0;
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			FAllocationCounter::Get().Begin();
+			const double StartTime = FPlatformTime::Seconds();
+			Function();
+			SamplesMs.Add((FPlatformTime::Seconds() - StartTime) * 1000.);
+			NumAllocations += FAllocationCounter::Get().End();
+		}
+		return MakeResult(Name, NumElements, SamplesMs, NumAllocations);
+	}
+
+	void RunDataHelpers(int32 MaxElements, TArray<FResult>& OutResults)
+	{
+		for (const int32 NumElements : ElementCounts)
+		{
+			if (NumElements > MaxElements)
+			{
+				break;
+			}
+
+			TArray<FName> Names;
+			TArray<FString> Strings;
+			TArray<int32> Ints;
+			TArray<float> Floats;
+			Names.Reserve(NumElements);
+			Strings.Reserve(NumElements);
+			Ints.Reserve(NumElements);
+			Floats.Reserve(NumElements);
+			for (int32 Index = 0; Index < NumElements; ++Index)
+			{
+				Names.Emplace(TEXT("AwesomeBLBenchmark"), Index);
+				Strings.Add(Names.Last().ToString());
+				Ints.Add(Index - NumElements / 2);
+				Floats.Add((Index - NumElements / 2) * 0.37f);
+			}
+
+			TArray<FString> StringTarget;
+			TArray<FName> NameTarget;
+			TArray<float> FloatTarget;
+			TArray<int32> IntTarget;
+			OutResults.Add(Measure(TEXT("NameArrayToStringArray"), NumElements, [&]() { UAwesomeBL::NameArrayToStringArray(Names, StringTarget); }));
+			OutResults.Add(Measure(TEXT("StringArrayToNameArray"), NumElements, [&]() { UAwesomeBL::StringArrayToNameArray(Strings, NameTarget); }));
+			OutResults.Add(Measure(TEXT("IntArrayToFloatArray"), NumElements, [&]() { UAwesomeBL::IntArrayToFloatArray(Ints, FloatTarget); }));
+			OutResults.Add(Measure(TEXT("FloatArrayToIntArray"), NumElements, [&]() { UAwesomeBL::FloatArrayToIntArray(Floats, IntTarget); }));
+
+			FAwesomeBLNameArena Arena;
+			OutResults.Add(Measure(TEXT("NameBatch.ToStringViews"), NumElements, [&]() { FAwesomeBLNameBatch::ToStringViews(Names, Arena); }));
+
+			float Sum = 0.f;
+			OutResults.Add(Measure(TEXT("ArrayMath.SumFloatArray"), NumElements, [&]() { Sum += UAwesomeBLArrayMath::SumFloatArray(Floats); }));
+			OutResults.Add(Measure(TEXT("ArrayMath.ClampFloatArrayInPlace"), NumElements, [&]() { UAwesomeBLArrayMath::ClampFloatArrayInPlace(FloatTarget, -100.f, 100.f); }));
+			OutResults.Add(Measure(TEXT("ArrayMath.FloatToIntArray.Round"), NumElements, [&]() { UAwesomeBLArrayMath::FloatToIntArray(Floats, EAwesomeBLRoundingMode::Round, IntTarget); }));
+			ensure(!FMath::IsNaN(Sum));
+		}
+	}
+
+	void RunComponentResolution(int32 MaxElements, TArray<FResult>& OutResults)
+	{
+		UWorld* World = UWorld::CreateWorld(EWorldType::None, false);
+		for (const int32 NumElements : ElementCounts)
+		{
+			if (NumElements > FMath::Min(MaxElements, MaxObjectElements))
+			{
+				break;
+			}
+
+			AActor* Actor = World->SpawnActor<AActor>();
+			USceneComponent* Root = NewObject<USceneComponent>(Actor, TEXT("Root"));
+			Actor->SetRootComponent(Root);
+			Actor->AddInstanceComponent(Root);
+
+			// References by path, plus the same number of references by property to cover both lookups.
+			TArray<FComponentReference> PathReferences;
+			TArray<FComponentReference> PropertyReferences;
+			TArray<FSoftComponentReference> SoftPathReferences;
+			TArray<FSoftComponentReference> SoftPropertyReferences;
+			for (int32 Index = 0; Index < NumElements; ++Index)
+			{
+				UActorComponent* Component = NewObject<UActorComponent>(Actor, FName(TEXT("AwesomeBLBenchmarkComponent"), Index));
+				Actor->AddInstanceComponent(Component);
+
+				PathReferences.AddDefaulted_GetRef().PathToComponent = Component->GetName();
+				SoftPathReferences.AddDefaulted_GetRef().PathToComponent = Component->GetName();
+				PropertyReferences.AddDefaulted_GetRef().ComponentProperty = TEXT("RootComponent");
+				SoftPropertyReferences.AddDefaulted_GetRef().ComponentProperty = TEXT("RootComponent");
+			}
+
+			int32 NumResolved = 0;
+			OutResults.Add(Measure(TEXT("GetComponent.Path"), NumElements, [&]()
+				{
+					for (const FComponentReference& Reference : PathReferences)
+					{
+						NumResolved += UAwesomeBL::GetComponent(Reference, Actor) ? 1 : 0;
+					}
+				}));
+			OutResults.Add(Measure(TEXT("GetComponent.Property"), NumElements, [&]()
+				{
+					for (const FComponentReference& Reference : PropertyReferences)
+					{
+						NumResolved += UAwesomeBL::GetComponent(Reference, Actor) ? 1 : 0;
+					}
+				}));
+			OutResults.Add(Measure(TEXT("GetComponentSoft.Path"), NumElements, [&]()
+				{
+					for (const FSoftComponentReference& Reference : SoftPathReferences)
+					{
+						NumResolved += UAwesomeBL::GetComponentSoft(Reference, Actor) ? 1 : 0;
+					}
+				}));
+			OutResults.Add(Measure(TEXT("GetComponentSoft.Property"), NumElements, [&]()
+				{
+					for (const FSoftComponentReference& Reference : SoftPropertyReferences)
+					{
+						NumResolved += UAwesomeBL::GetComponentSoft(Reference, Actor) ? 1 : 0;
+					}
+				}));
+			ensureMsgf(NumResolved > 0, TEXT("Benchmark references did not resolve"));
+
+			Actor->Destroy();
+		}
+		World->DestroyWorld(false);
+	}
+
+	/**
+	 * Times the async load wrappers from request to callback over real frames, one case at a time. The assets are
+	 * transient objects, so this measures the cost of the wrappers and the streamable manager, not IO.
+	 */
+	class FAsyncRunner : public TSharedFromThis<FAsyncRunner>
+	{
+	public:
+
+		FAsyncRunner(int32 InMaxElements, TArray<FResult>&& InResults, bool bInQuit)
+			: Results(MoveTemp(InResults))
+			, bQuit(bInQuit)
+		{
+			for (const int32 NumElements : ElementCounts)
+			{
+				if (NumElements <= FMath::Min(InMaxElements, MaxObjectElements))
+				{
+					Cases.Add({ TEXT("TAsyncLoadAssets"), NumElements, false });
+					Cases.Add({ TEXT("TAsyncLoadAsset"), NumElements, true });
+				}
+			}
+		}
+
+		void Start()
+		{
+			if (IConsoleVariable* LoadStatsCVar = IConsoleManager::Get().FindConsoleVariable(LoadStatsCVarName))
+			{
+				bLoadStatsWereEnabled = LoadStatsCVar->GetBool();
+				LoadStatsCVar->Set(true, ECVF_SetByCode);
+			}
+
+			// The ticker owns the runner until the last case is written.
+			FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([This = AsShared()](float DeltaTime)
+				{
+					return This->Tick(DeltaTime);
+				}));
+		}
+
+	private:
+
+		struct FCase
+		{
+			const TCHAR* Name;
+			int32 NumElements;
+			bool bSingleAssetLoads;
+		};
+
+		bool Tick(float)
+		{
+			if (NumPending > 0)
+			{
+				return true;
+			}
+
+			if (CaseIndex < Cases.Num())
+			{
+				if (Iteration == NumAsyncIterations)
+				{
+					Results.Add(MakeResult(Cases[CaseIndex].Name, Cases[CaseIndex].NumElements, SamplesMs, NumAllocations, NumFrames));
+					SamplesMs.Reset();
+					NumAllocations = 0;
+					NumFrames = 0;
+					Iteration = 0;
+					++CaseIndex;
+				}
+				if (CaseIndex < Cases.Num())
+				{
+					StartIteration(Cases[CaseIndex]);
+					return true;
+				}
+			}
+
+			Assets.Empty();
+			Finish();
+			return false;
+		}
+
+		void StartIteration(const FCase& Case)
+		{
+			Assets.Reset();
+			TArray<TSoftObjectPtr<UObject>> SoftAssets;
+			SoftAssets.Reserve(Case.NumElements);
+			for (int32 Index = 0; Index < Case.NumElements; ++Index)
+			{
+				Assets.Emplace(NewObject<UAwesomeBLLoadRequest>());
+				SoftAssets.Emplace(Assets.Last().Get());
+			}
+
+			++Iteration;
+			FAllocationCounter::Get().Begin();
+			StartTime = FPlatformTime::Seconds();
+			StartFrame = GFrameCounter;
+			if (Case.bSingleAssetLoads)
+			{
+				NumPending = SoftAssets.Num();
+				for (const TSoftObjectPtr<UObject>& SoftAsset : SoftAssets)
+				{
+					UAwesomeBL::TAsyncLoadAsset<UObject>(SoftAsset, TDelegate<void(UObject*)>::CreateSPLambda(this, [this](UObject*) { OnLoaded(); }));
+				}
+			}
+			else
+			{
+				NumPending = 1;
+				UAwesomeBL::TAsyncLoadAssets<UObject>(SoftAssets, TDelegate<void(const TArray<UObject*>&)>::CreateSPLambda(this, [this](const TArray<UObject*>&) { OnLoaded(); }));
+			}
+			NumAllocations += FAllocationCounter::Get().End();
+		}
+
+		void OnLoaded()
+		{
+			if (--NumPending == 0)
+			{
+				SamplesMs.Add((FPlatformTime::Seconds() - StartTime) * 1000.);
+				NumFrames += static_cast<int32>(GFrameCounter - StartFrame);
+			}
+		}
+
+		void Finish()
+		{
+			if (IConsoleVariable* LoadStatsCVar = IConsoleManager::Get().FindConsoleVariable(LoadStatsCVarName))
+			{
+				LoadStatsCVar->Set(bLoadStatsWereEnabled, ECVF_SetByCode);
+			}
+			FAllocationCounter::Get().Uninstall();
+
+			TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+			Root->SetStringField(TEXT("plugin"), TEXT("AwesomeBlueprintLibrary"));
+			Root->SetStringField(TEXT("engineVersion"), FEngineVersion::Current().ToString());
+			Root->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+			Root->SetStringField(TEXT("configuration"), LexToString(FApp::GetBuildConfiguration()));
+			Root->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+
+			TArray<TSharedPtr<FJsonValue>> JsonResults;
+			for (const FResult& Result : Results)
+			{
+				TSharedRef<FJsonObject> JsonResult = MakeShared<FJsonObject>();
+				JsonResult->SetStringField(TEXT("name"), Result.Name);
+				JsonResult->SetNumberField(TEXT("elements"), Result.NumElements);
+				JsonResult->SetNumberField(TEXT("iterations"), Result.NumIterations);
+				JsonResult->SetNumberField(TEXT("minMs"), Result.MinMs);
+				JsonResult->SetNumberField(TEXT("medianMs"), Result.MedianMs);
+				JsonResult->SetNumberField(TEXT("meanMs"), Result.MeanMs);
+				JsonResult->SetNumberField(TEXT("nsPerElement"), Result.MedianMs * 1000000. / Result.NumElements);
+				JsonResult->SetNumberField(TEXT("allocations"), Result.NumAllocations);
+				if (Result.NumFrames > 0)
+				{
+					JsonResult->SetNumberField(TEXT("meanFrames"), static_cast<double>(Result.NumFrames) / Result.NumIterations);
+				}
+				JsonResults.Add(MakeShared<FJsonValueObject>(JsonResult));
+			}
+			Root->SetArrayField(TEXT("results"), JsonResults);
+
+			FString Json;
+			FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Json));
+
+			const FString FilePath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FString::Printf(TEXT("AwesomeBL-%s.json"), *FDateTime::Now().ToString());
+			if (FFileHelper::SaveStringToFile(Json, *FilePath))
+			{
+				UE_LOG(LogAwesomeBL, Display, TEXT("Benchmarks written to %s"), *IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*FilePath));
+			}
+			else
+			{
+				UE_LOG(LogAwesomeBL, Error, TEXT("Failed to write benchmarks to %s"), *FilePath);
+			}
+
+			if (bQuit)
+			{
+				FPlatformMisc::RequestExit(false);
+			}
+		}
+
+		TArray<FResult> Results;
+		TArray<FCase> Cases;
+		TArray<TStrongObjectPtr<UObject>> Assets;
+		TArray<double> SamplesMs;
+		double StartTime = 0.;
+		uint64 StartFrame = 0;
+		int64 NumAllocations = 0;
+		int32 CaseIndex = 0;
+		int32 Iteration = 0;
+		int32 NumPending = 0;
+		int32 NumFrames = 0;
+		bool bQuit = false;
+		bool bLoadStatsWereEnabled = false;
+	};
+
+	void Run(const TArray<FString>& Args)
+	{
+		int32 MaxElements = 1000000;
+		bool bQuit = false;
+		for (const FString& Arg : Args)
+		{
+			if (Arg.Equals(TEXT("Quit"), ESearchCase::IgnoreCase))
+			{
+				bQuit = true;
+			}
+			else if (Arg.IsNumeric())
+			{
+				MaxElements = FCString::Atoi(*Arg);
+			}
+		}
+
+		UE_LOG(LogAwesomeBL, Display, TEXT("Running benchmarks up to %d elements"), MaxElements);
+
+		// Uninstalled by the async runner once the last case is written.
+		FAllocationCounter::Get().Install();
+
+		TArray<FResult> Results;
+		RunDataHelpers(MaxElements, Results);
+		RunComponentResolution(MaxElements, Results);
+
+		// Async loads need the engine to tick, the runner keeps itself alive through its ticker and writes the file once done.
+		const TSharedRef<FAsyncRunner> AsyncRunner = MakeShared<FAsyncRunner>(MaxElements, MoveTemp(Results), bQuit);
+		AsyncRunner->Start();
+	}
+}
+
+static FAutoConsoleCommand AwesomeBLRunBenchmarksCommand(
+	TEXT("AwesomeBL.RunBenchmarks"),
+	TEXT("Benchmark the Data Helpers, component resolution and async load wrappers and write the results to Saved/Benchmarks as JSON. ")
+	TEXT("Args: [MaxElements, default 1000000] [Quit, exit once done]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&AwesomeBLBenchmarks::Run));
+
+#endif
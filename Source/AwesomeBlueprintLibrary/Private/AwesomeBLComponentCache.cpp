@@ -0,0 +1,194 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLComponentCache.h"
+
+#include "AwesomeBLLoadStats.h"
+#include "Components/ActorComponent.h"
+#include "GameFramework/Actor.h"
+#include "Misc/EngineVersionComparison.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Component Cache Hits"), STAT_AwesomeBL_ComponentCacheHits, STATGROUP_AwesomeBL);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Component Cache Misses"), STAT_AwesomeBL_ComponentCacheMisses, STATGROUP_AwesomeBL);
+
+static TAutoConsoleVariable<bool> CVarAwesomeBLComponentCacheEnabled(
+	TEXT("AwesomeBL.ComponentCache.Enabled"),
+	true,
+	TEXT("Cache what component references resolved to for GetComponent and GetComponentSoft."));
+
+namespace AwesomeBLComponentCache
+{
+	UActorComponent* GetOverrideComponent(const FComponentReference& Reference)
+	{
+		return Reference.OverrideComponent.Get();
+	}
+
+	UActorComponent* GetOverrideComponent(const FSoftComponentReference& Reference)
+	{
+#if UE_VERSION_OLDER_THAN(5, 2, 0)
+		// Soft references can't override the component before 5.2.
+		return nullptr;
+#else
+		return Reference.OverrideComponent.Get();
+#endif
+	}
+}
+
+FAwesomeBLComponentCache& FAwesomeBLComponentCache::Get()
+{
+	static FAwesomeBLComponentCache Cache;
+	return Cache;
+}
+
+UActorComponent* FAwesomeBLComponentCache::GetComponent(const FComponentReference& Reference, AActor* OwningActor)
+{
+	return Resolve(Reference, OwningActor);
+}
+
+UActorComponent* FAwesomeBLComponentCache::GetComponent(const FSoftComponentReference& Reference, AActor* OwningActor)
+{
+	return Resolve(Reference, OwningActor);
+}
+
+void FAwesomeBLComponentCache::ResetStats()
+{
+	NumHits = 0;
+	NumMisses = 0;
+}
+
+void FAwesomeBLComponentCache::Empty()
+{
+	PathEntries.Empty();
+	ComponentProperties.Empty();
+}
+
+template<typename ReferenceType>
+UActorComponent* FAwesomeBLComponentCache::Resolve(const ReferenceType& Reference, AActor* OwningActor)
+{
+	if (!IsInGameThread() || !CVarAwesomeBLComponentCacheEnabled.GetValueOnGameThread())
+	{
+		return Reference.GetComponent(OwningActor);
+	}
+
+	// Same override, search actor and order of lookups as the engine.
+	if (UActorComponent* OverrideComponent = AwesomeBLComponentCache::GetOverrideComponent(Reference))
+	{
+		return OverrideComponent;
+	}
+
+	AActor* SearchActor = Reference.OtherActor.IsValid() ? Reference.OtherActor.Get() : OwningActor;
+	if (!SearchActor)
+	{
+		return Reference.GetComponent(OwningActor);
+	}
+
+	if (Reference.ComponentProperty != NAME_None)
+	{
+		const FObjectPropertyBase* Property = FindComponentProperty(SearchActor->GetClass(), Reference.ComponentProperty);
+		return Property ? Cast<UActorComponent>(Property->GetObjectPropertyValue_InContainer(SearchActor)) : nullptr;
+	}
+
+	if (!Reference.PathToComponent.IsEmpty())
+	{
+		return FindComponentByPath(SearchActor, Reference.PathToComponent);
+	}
+
+	return SearchActor->GetRootComponent();
+}
+
+FObjectPropertyBase* FAwesomeBLComponentCache::FindComponentProperty(UClass* Class, FName ComponentProperty)
+{
+	EnsurePurgeRegistered();
+
+	const TPair<TObjectKey<UClass>, FName> Key(Class, ComponentProperty);
+	if (const TFieldPath<FObjectPropertyBase>* PropertyPath = ComponentProperties.Find(Key))
+	{
+		// A path that no longer resolves lost its property to a recompile and is looked up again.
+		FObjectPropertyBase* Property = PropertyPath->Get(Class);
+		if (Property || PropertyPath->IsPathToFieldEmpty())
+		{
+			++NumHits;
+			INC_DWORD_STAT(STAT_AwesomeBL_ComponentCacheHits);
+			return Property;
+		}
+	}
+
+	++NumMisses;
+	INC_DWORD_STAT(STAT_AwesomeBL_ComponentCacheMisses);
+	FObjectPropertyBase* Property = FindFProperty<FObjectPropertyBase>(Class, ComponentProperty);
+	ComponentProperties.Add(Key, TFieldPath<FObjectPropertyBase>(Property));
+	return Property;
+}
+
+UActorComponent* FAwesomeBLComponentCache::FindComponentByPath(AActor* SearchActor, const FString& PathToComponent)
+{
+	EnsurePurgeRegistered();
+
+	const int32 NumComponents = SearchActor->GetComponents().Num();
+	const TPair<TObjectKey<AActor>, uint32> Key(SearchActor, GetTypeHash(PathToComponent));
+	FPathEntry& Entry = PathEntries.FindOrAdd(Key);
+
+	UActorComponent* Component = Entry.Component.Get();
+	if (Component && Component->GetOwner() == SearchActor && Entry.NumComponents == NumComponents && Entry.PathToComponent.Equals(PathToComponent, ESearchCase::IgnoreCase))
+	{
+		++NumHits;
+		INC_DWORD_STAT(STAT_AwesomeBL_ComponentCacheHits);
+		return Component;
+	}
+
+	++NumMisses;
+	INC_DWORD_STAT(STAT_AwesomeBL_ComponentCacheMisses);
+	Component = FindObject<UActorComponent>(SearchActor, *PathToComponent);
+
+	// Components that don't exist yet are not remembered, the next call searches again.
+	if (Component)
+	{
+		Entry.PathToComponent = PathToComponent;
+		Entry.Component = Component;
+		Entry.NumComponents = NumComponents;
+	}
+	else
+	{
+		PathEntries.Remove(Key);
+	}
+	return Component;
+}
+
+void FAwesomeBLComponentCache::EnsurePurgeRegistered()
+{
+	if (!PostGarbageCollectHandle.IsValid())
+	{
+		PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FAwesomeBLComponentCache::PurgeStaleEntries);
+	}
+
+#if WITH_EDITOR
+	// Blueprint recompiles reinstance their objects, properties may have been added or renamed since the lookup.
+	if (!ObjectsReplacedHandle.IsValid())
+	{
+		ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddLambda([this](const TMap<UObject*, UObject*>&)
+			{
+				ComponentProperties.Empty();
+			});
+	}
+#endif
+}
+
+void FAwesomeBLComponentCache::PurgeStaleEntries()
+{
+	for (auto It = PathEntries.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().Key.ResolveObjectPtr() || !It.Value().Component.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = ComponentProperties.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().Key.ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
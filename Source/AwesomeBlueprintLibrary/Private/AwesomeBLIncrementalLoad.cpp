@@ -0,0 +1,179 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLIncrementalLoad.h"
+
+#include "Engine/AssetManager.h"
+
+namespace AwesomeBLIncrementalLoad
+{
+	struct FState
+	{
+		TArray<FSoftObjectPath> Paths;
+		TArray<FPrimaryAssetId> PrimaryAssetIds;
+
+		/** Paths each primary asset needs with its bundles, index aligned with PrimaryAssetIds */
+		TArray<TArray<FSoftObjectPath>> BundlePaths;
+
+		/** First bundle path of each primary asset not seen loaded yet, so every path is only resolved until it loads */
+		TArray<int32> NextBundlePaths;
+
+		/**
+		 * Own request for the bundle paths of a primary asset load, only there to report progress. The handle returned
+		 * by the asset manager may be shared with other callers, so its update delegate is not ours to bind.
+		 */
+		TSharedPtr<FStreamableHandle> ProgressHandle;
+
+		/** Indices not reported yet, kept in request order */
+		TArray<int32> PendingIndices;
+
+		FAwesomeBLLoadProgress Progress;
+		FAwesomeBLIncrementalLoad::FOnAssetLoaded OnAssetLoaded;
+
+		/** @return The asset once it and, for primary assets, its requested bundles have loaded */
+		UObject* Resolve(const int32 Index, const bool bFinal)
+		{
+			if (PrimaryAssetIds.IsEmpty())
+			{
+				return Paths[Index].ResolveObject();
+			}
+
+			const UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+			if (!AssetManager)
+			{
+				return nullptr;
+			}
+
+			// Once the request has finished, bundle assets that failed to load do not hold back the primary asset.
+			if (!bFinal)
+			{
+				const TArray<FSoftObjectPath>& AssetPaths = BundlePaths[Index];
+				int32& NextPath = NextBundlePaths[Index];
+				for (; NextPath < AssetPaths.Num(); ++NextPath)
+				{
+					if (!AssetPaths[NextPath].ResolveObject())
+					{
+						return nullptr;
+					}
+				}
+			}
+			return AssetManager->GetPrimaryAssetObject(PrimaryAssetIds[Index]);
+		}
+
+		/** Report every pending asset that has loaded since the last poll */
+		void Poll(const bool bFinal)
+		{
+			int32 NumStillPending = 0;
+			for (int32 PendingIndex = 0; PendingIndex < PendingIndices.Num(); ++PendingIndex)
+			{
+				const int32 Index = PendingIndices[PendingIndex];
+				if (UObject* LoadedAsset = Resolve(Index, bFinal))
+				{
+					++Progress.NumLoaded;
+					Progress.LoadedBytes += LoadedAsset->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+					OnAssetLoaded(Index, LoadedAsset, Progress);
+				}
+				else
+				{
+					PendingIndices[NumStillPending++] = Index;
+				}
+			}
+			PendingIndices.SetNum(NumStillPending, false);
+		}
+	};
+
+	/** Hook the state up to the handle so every load update reports the newly loaded assets */
+	void Track(const TSharedRef<FState>& State, const TSharedPtr<FStreamableHandle>& Handle)
+	{
+		if (Handle.IsValid() && Handle->IsLoadingInProgress())
+		{
+			Handle->BindUpdateDelegate(FStreamableUpdateDelegate::CreateLambda([WeakState = TWeakPtr<FState>(State)](TSharedRef<FStreamableHandle>)
+				{
+					if (const TSharedPtr<FState> PinnedState = WeakState.Pin())
+					{
+						PinnedState->Poll(false);
+					}
+				}));
+		}
+	}
+
+	/** Report what is left and finish. Assets that failed to load are never reported */
+	FStreamableDelegate MakeOnComplete(const TSharedRef<FState>& State, FStreamableDelegate&& OnComplete)
+	{
+		return FStreamableDelegate::CreateLambda([State, OnComplete = MoveTemp(OnComplete)]()
+			{
+				State->ProgressHandle.Reset();
+				State->Poll(true);
+				OnComplete.ExecuteIfBound();
+			});
+	}
+}
+
+TSharedPtr<FStreamableHandle> FAwesomeBLIncrementalLoad::RequestAsyncLoad(TArray<FSoftObjectPath> Paths, FOnAssetLoaded OnAssetLoaded, FStreamableDelegate OnComplete, TAsyncLoadPriority Priority)
+{
+	check(IsInGameThread());
+	using namespace AwesomeBLIncrementalLoad;
+
+	const TSharedRef<FState> State = MakeShared<FState>();
+	State->OnAssetLoaded = MoveTemp(OnAssetLoaded);
+
+	TArray<FSoftObjectPath> PathsToLoad;
+	PathsToLoad.Reserve(Paths.Num());
+	for (int32 Index = 0; Index < Paths.Num(); ++Index)
+	{
+		if (!Paths[Index].IsNull())
+		{
+			PathsToLoad.Add(Paths[Index]);
+			State->PendingIndices.Add(Index);
+		}
+	}
+	State->Progress.NumTotal = State->PendingIndices.Num();
+	State->Paths = MoveTemp(Paths);
+
+	// Not coalesced, the update delegate of a shared handle would be overwritten by the next streaming caller.
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(PathsToLoad), MakeOnComplete(State, MoveTemp(OnComplete)), Priority);
+	Track(State, Handle);
+	return Handle;
+}
+
+TSharedPtr<FStreamableHandle> FAwesomeBLIncrementalLoad::LoadPrimaryAssets(const TArray<FPrimaryAssetId>& PrimaryAssetIds, const TArray<FName>& LoadBundles, FOnAssetLoaded OnAssetLoaded, FStreamableDelegate OnComplete, TAsyncLoadPriority Priority)
+{
+	check(IsInGameThread());
+	using namespace AwesomeBLIncrementalLoad;
+
+	UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+	if (!AssetManager)
+	{
+		return nullptr;
+	}
+
+	const TSharedRef<FState> State = MakeShared<FState>();
+	State->OnAssetLoaded = MoveTemp(OnAssetLoaded);
+	State->PrimaryAssetIds = PrimaryAssetIds;
+	State->BundlePaths.SetNum(PrimaryAssetIds.Num());
+	State->NextBundlePaths.SetNumZeroed(PrimaryAssetIds.Num());
+	State->PendingIndices.Reserve(PrimaryAssetIds.Num());
+	TSet<FSoftObjectPath> AllPaths;
+	for (int32 Index = 0; Index < PrimaryAssetIds.Num(); ++Index)
+	{
+		if (PrimaryAssetIds[Index].IsValid())
+		{
+			TSet<FSoftObjectPath> LoadSet;
+			AssetManager->GetPrimaryAssetLoadSet(LoadSet, PrimaryAssetIds[Index], LoadBundles, false);
+			AllPaths.Append(LoadSet);
+			State->BundlePaths[Index] = LoadSet.Array();
+			State->PendingIndices.Add(Index);
+		}
+	}
+	State->Progress.NumTotal = State->PendingIndices.Num();
+
+	TSharedPtr<FStreamableHandle> Handle = AssetManager->LoadPrimaryAssets(PrimaryAssetIds, LoadBundles, MakeOnComplete(State, MoveTemp(OnComplete)), Priority);
+
+	// The same paths are in flight for the asset manager's request, the streamable manager shares their loads.
+	if (Handle.IsValid() && Handle->IsLoadingInProgress() && !AllPaths.IsEmpty())
+	{
+		State->ProgressHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AllPaths.Array(), FStreamableDelegate(), Priority);
+		Track(State, State->ProgressHandle);
+	}
+	return Handle;
+}
@@ -0,0 +1,224 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLInputTrack.h"
+
+#include "AwesomeBLModule.h"
+#include "Algo/StableSort.h"
+#include "Framework/Application/IInputProcessor.h"
+#include "Framework/Application/SlateApplication.h"
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+
+namespace AwesomeBLInputTrack
+{
+	/** Appends what Slate receives to a track, without handling it */
+	class FRecorder : public IInputProcessor
+	{
+	public:
+
+		FAwesomeBLInputTrack Track;
+		uint64 StartFrame = GFrameCounter;
+
+		//~ Begin IInputProcessor Interface
+		virtual void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override {}
+
+		virtual bool HandleKeyDownEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent) override
+		{
+			Add(EAwesomeBLInputEventType::Pressed, InKeyEvent, 0.f);
+			return false;
+		}
+
+		virtual bool HandleKeyUpEvent(FSlateApplication& SlateApp, const FKeyEvent& InKeyEvent) override
+		{
+			Add(EAwesomeBLInputEventType::Released, InKeyEvent, 0.f);
+			return false;
+		}
+
+		virtual bool HandleAnalogInputEvent(FSlateApplication& SlateApp, const FAnalogInputEvent& InAnalogInputEvent) override
+		{
+			Add(EAwesomeBLInputEventType::Analog, InAnalogInputEvent, InAnalogInputEvent.GetAnalogValue());
+			return false;
+		}
+
+		virtual const TCHAR* GetDebugName() const override { return TEXT("AwesomeBLInputRecorder"); }
+		//~ End IInputProcessor Interface
+
+	private:
+
+		void Add(EAwesomeBLInputEventType Type, const FKeyEvent& KeyEvent, float AnalogValue)
+		{
+			// Played back tracks would otherwise be recorded into the next one.
+			if (FAwesomeBLInputTrackPlayer::Get().IsPlaying())
+			{
+				return;
+			}
+
+			FAwesomeBLInputEvent& Event = Track.Events.AddDefaulted_GetRef();
+			Event.Frame = static_cast<int32>(GFrameCounter - StartFrame);
+			Event.Type = Type;
+			Event.Key = KeyEvent.GetKey();
+			Event.AnalogValue = AnalogValue;
+			Event.ControllerId = KeyEvent.GetUserIndex();
+			Event.bRepeat = KeyEvent.IsRepeat();
+		}
+	};
+}
+
+void FAwesomeBLInputEvent::PrepareCodes()
+{
+	const uint32* KeyCodePtr;
+	const uint32* CharCodePtr;
+	FInputKeyManager::Get().GetCodesFromKey(Key, KeyCodePtr, CharCodePtr);
+
+	KeyCode = KeyCodePtr ? *KeyCodePtr : 0;
+	CharCode = CharCodePtr ? *CharCodePtr : 0;
+	bHasCharCode = CharCodePtr != nullptr;
+}
+
+void FAwesomeBLInputEvent::Inject() const
+{
+	FSlateApplication& SlateApp = FSlateApplication::Get();
+	switch (Type)
+	{
+	case EAwesomeBLInputEventType::Analog:
+		{
+			const FAnalogInputEvent AnalogInputEvent(Key, FModifierKeysState(), ControllerId, bRepeat, CharCode, KeyCode, AnalogValue);
+			SlateApp.ProcessAnalogInputEvent(AnalogInputEvent);
+			break;
+		}
+	case EAwesomeBLInputEventType::Pressed:
+		{
+			const FKeyEvent KeyEvent(Key, FModifierKeysState(), ControllerId, bRepeat, KeyCode, CharCode);
+			SlateApp.ProcessKeyDownEvent(KeyEvent);
+
+			if (bHasCharCode)
+			{
+				const FCharacterEvent CharacterEvent(CharCode, FModifierKeysState(), ControllerId, bRepeat);
+				SlateApp.ProcessKeyCharEvent(CharacterEvent);
+			}
+			break;
+		}
+	case EAwesomeBLInputEventType::Released:
+		{
+			const FKeyEvent KeyEvent(Key, FModifierKeysState(), ControllerId, bRepeat, KeyCode, CharCode);
+			SlateApp.ProcessKeyUpEvent(KeyEvent);
+			break;
+		}
+	}
+}
+
+void FAwesomeBLInputTrack::Prepare()
+{
+	Algo::StableSortBy(Events, &FAwesomeBLInputEvent::Frame);
+	for (FAwesomeBLInputEvent& Event : Events)
+	{
+		Event.PrepareCodes();
+	}
+}
+
+bool FAwesomeBLInputTrack::SaveToFile(const FString& Filename) const
+{
+	FString Json;
+	if (!FJsonObjectConverter::UStructToJsonObjectString(*this, Json))
+	{
+		return false;
+	}
+	return FFileHelper::SaveStringToFile(Json, *Filename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+bool FAwesomeBLInputTrack::LoadFromFile(const FString& Filename)
+{
+	FString Json;
+	if (!FFileHelper::LoadFileToString(Json, *Filename) || !FJsonObjectConverter::JsonObjectStringToUStruct(Json, this))
+	{
+		UE_LOG(LogAwesomeBL, Warning, TEXT("Failed to load input track %s"), *Filename);
+		return false;
+	}
+
+	Prepare();
+	return true;
+}
+
+FAwesomeBLInputTrackPlayer& FAwesomeBLInputTrackPlayer::Get()
+{
+	static FAwesomeBLInputTrackPlayer Player;
+	return Player;
+}
+
+void FAwesomeBLInputTrackPlayer::StartRecording()
+{
+	if (!FSlateApplication::IsInitialized())
+	{
+		return;
+	}
+
+	StopRecording();
+	Recorder = MakeShared<AwesomeBLInputTrack::FRecorder>();
+	FSlateApplication::Get().RegisterInputPreProcessor(Recorder, 0);
+}
+
+FAwesomeBLInputTrack FAwesomeBLInputTrackPlayer::StopRecording()
+{
+	if (!Recorder.IsValid())
+	{
+		return FAwesomeBLInputTrack();
+	}
+
+	if (FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().UnregisterInputPreProcessor(Recorder);
+	}
+
+	FAwesomeBLInputTrack Track = MoveTemp(StaticCastSharedPtr<AwesomeBLInputTrack::FRecorder>(Recorder)->Track);
+	Recorder.Reset();
+	Track.Prepare();
+	return Track;
+}
+
+void FAwesomeBLInputTrackPlayer::Play(FAwesomeBLInputTrack Track)
+{
+	Stop();
+
+	if (!FSlateApplication::IsInitialized())
+	{
+		return;
+	}
+
+	PlayingTrack = MoveTemp(Track);
+	PlayingTrack.Prepare();
+	NextEvent = 0;
+	StartFrame = GFrameCounter;
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FAwesomeBLInputTrackPlayer::Tick));
+}
+
+void FAwesomeBLInputTrackPlayer::Stop()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+	PlayingTrack.Events.Empty();
+	NextEvent = 0;
+}
+
+bool FAwesomeBLInputTrackPlayer::Tick(float DeltaTime)
+{
+	const int32 Frame = static_cast<int32>(GFrameCounter - StartFrame);
+	const TArray<FAwesomeBLInputEvent>& Events = PlayingTrack.Events;
+	while (NextEvent < Events.Num() && Events[NextEvent].Frame <= Frame)
+	{
+		Events[NextEvent++].Inject();
+	}
+
+	if (NextEvent < Events.Num())
+	{
+		return true;
+	}
+
+	TickerHandle.Reset();
+	PlayingTrack.Events.Empty();
+	OnFinished.Broadcast();
+	return false;
+}
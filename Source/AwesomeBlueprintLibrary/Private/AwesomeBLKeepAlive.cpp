@@ -0,0 +1,189 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLKeepAlive.h"
+
+#include "AwesomeBLLoadStats.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Keep-Alive Objects"), STAT_AwesomeBL_KeepAliveObjects, STATGROUP_AwesomeBL);
+
+static TAutoConsoleVariable<bool> CVarAwesomeBLKeepAliveTrackMemory(
+	TEXT("AwesomeBL.KeepAlive.TrackMemory"),
+	false,
+	TEXT("Sample the resource size of objects registered with the keep-alive subsystem for its per-group memory stats. Off by default as sampling walks the object on every register."));
+
+static FAutoConsoleCommandWithOutputDevice AwesomeBLDumpKeepAliveCommand(
+	TEXT("AwesomeBL.DumpKeepAlive"),
+	TEXT("Log the keep-alive groups of every game instance."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+		{
+			if (!GEngine)
+			{
+				return;
+			}
+			for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+			{
+				if (const UAwesomeBLKeepAlive* KeepAlive = WorldContext.OwningGameInstance ? WorldContext.OwningGameInstance->GetSubsystem<UAwesomeBLKeepAlive>() : nullptr)
+				{
+					Ar.Logf(TEXT("%s:"), *WorldContext.OwningGameInstance->GetName());
+					KeepAlive->Dump(Ar);
+				}
+			}
+		}));
+
+UAwesomeBLKeepAlive* UAwesomeBLKeepAlive::Get(const UObject* WorldContextObject)
+{
+	const UGameInstance* GameInstance = WorldContextObject ? UGameplayStatics::GetGameInstance(WorldContextObject) : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UAwesomeBLKeepAlive>() : nullptr;
+}
+
+void UAwesomeBLKeepAlive::Register(UObject* Object, FName Group)
+{
+	if (!Object)
+	{
+		return;
+	}
+
+	FGroup& KeepAliveGroup = Groups.FindOrAdd(Group);
+	const TObjectKey<UObject> Key(Object);
+	const uint32 Hash = GetTypeHash(Key);
+	if (KeepAliveGroup.Objects.ContainsByHash(Hash, Key))
+	{
+		return;
+	}
+
+	FEntry Entry;
+	Entry.Object = Object;
+	Entry.ResourceBytes = CVarAwesomeBLKeepAliveTrackMemory.GetValueOnGameThread() ? Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive) : 0;
+	KeepAliveGroup.ResourceBytes += Entry.ResourceBytes;
+	KeepAliveGroup.Objects.AddByHash(Hash, Key, MoveTemp(Entry));
+	++NumObjects;
+	INC_DWORD_STAT(STAT_AwesomeBL_KeepAliveObjects);
+}
+
+void UAwesomeBLKeepAlive::Unregister(UObject* Object, FName Group)
+{
+	FGroup* KeepAliveGroup = Groups.Find(Group);
+	FEntry Entry;
+	if (!KeepAliveGroup || !KeepAliveGroup->Objects.RemoveAndCopyValue(TObjectKey<UObject>(Object), Entry))
+	{
+		return;
+	}
+
+	KeepAliveGroup->ResourceBytes -= Entry.ResourceBytes;
+	--NumObjects;
+	DEC_DWORD_STAT(STAT_AwesomeBL_KeepAliveObjects);
+	if (KeepAliveGroup->Objects.IsEmpty())
+	{
+		Groups.Remove(Group);
+	}
+}
+
+int32 UAwesomeBLKeepAlive::ReleaseGroup(FName Group)
+{
+	FGroup KeepAliveGroup;
+	if (!Groups.RemoveAndCopyValue(Group, KeepAliveGroup))
+	{
+		return 0;
+	}
+
+	const int32 NumReleased = KeepAliveGroup.Objects.Num();
+	NumObjects -= NumReleased;
+	DEC_DWORD_STAT_BY(STAT_AwesomeBL_KeepAliveObjects, NumReleased);
+	return NumReleased;
+}
+
+bool UAwesomeBLKeepAlive::IsRegistered(const UObject* Object, FName Group) const
+{
+	const FGroup* KeepAliveGroup = Groups.Find(Group);
+	return KeepAliveGroup && KeepAliveGroup->Objects.Contains(TObjectKey<UObject>(Object));
+}
+
+TArray<FAwesomeBLKeepAliveGroupStats> UAwesomeBLKeepAlive::GetGroupStats() const
+{
+	TArray<FAwesomeBLKeepAliveGroupStats> Stats;
+	Stats.Reserve(Groups.Num());
+	for (const TPair<FName, FGroup>& Pair : Groups)
+	{
+		FAwesomeBLKeepAliveGroupStats& GroupStats = Stats.AddDefaulted_GetRef();
+		GroupStats.Group = Pair.Key;
+		GroupStats.NumObjects = Pair.Value.Objects.Num();
+		GroupStats.ResourceBytes = Pair.Value.ResourceBytes;
+	}
+	return Stats;
+}
+
+void UAwesomeBLKeepAlive::Dump(FOutputDevice& Ar) const
+{
+	TArray<FAwesomeBLKeepAliveGroupStats> Stats = GetGroupStats();
+	Stats.Sort([](const FAwesomeBLKeepAliveGroupStats& A, const FAwesomeBLKeepAliveGroupStats& B) { return A.ResourceBytes > B.ResourceBytes; });
+
+	Ar.Logf(TEXT("  %d objects in %d groups"), NumObjects, Stats.Num());
+	for (const FAwesomeBLKeepAliveGroupStats& GroupStats : Stats)
+	{
+		Ar.Logf(TEXT("  %-32s %8d objects %10.2f MB"), *GroupStats.Group.ToString(), GroupStats.NumObjects, GroupStats.ResourceBytes / (1024. * 1024.));
+	}
+}
+
+void UAwesomeBLKeepAlive::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	UAwesomeBLKeepAlive* This = CastChecked<UAwesomeBLKeepAlive>(InThis);
+	for (TPair<FName, FGroup>& Pair : This->Groups)
+	{
+		// Objects marked as garbage get cleared here, their entries are dropped once the collection is done.
+		for (TPair<TObjectKey<UObject>, FEntry>& Entry : Pair.Value.Objects)
+		{
+			Collector.AddReferencedObject(Entry.Value.Object, This);
+		}
+	}
+
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+void UAwesomeBLKeepAlive::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UAwesomeBLKeepAlive::OnPostGarbageCollect);
+}
+
+void UAwesomeBLKeepAlive::OnPostGarbageCollect()
+{
+	int32 NumPruned = 0;
+	for (auto GroupIt = Groups.CreateIterator(); GroupIt; ++GroupIt)
+	{
+		FGroup& KeepAliveGroup = GroupIt.Value();
+		for (auto It = KeepAliveGroup.Objects.CreateIterator(); It; ++It)
+		{
+			if (!It.Value().Object)
+			{
+				KeepAliveGroup.ResourceBytes -= It.Value().ResourceBytes;
+				++NumPruned;
+				It.RemoveCurrent();
+			}
+		}
+
+		if (KeepAliveGroup.Objects.IsEmpty())
+		{
+			GroupIt.RemoveCurrent();
+		}
+	}
+
+	NumObjects -= NumPruned;
+	DEC_DWORD_STAT_BY(STAT_AwesomeBL_KeepAliveObjects, NumPruned);
+}
+
+void UAwesomeBLKeepAlive::Deinitialize()
+{
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	PostGarbageCollectHandle.Reset();
+
+	DEC_DWORD_STAT_BY(STAT_AwesomeBL_KeepAliveObjects, NumObjects);
+	Groups.Empty();
+	NumObjects = 0;
+	Super::Deinitialize();
+}
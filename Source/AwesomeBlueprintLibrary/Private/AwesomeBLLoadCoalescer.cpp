@@ -0,0 +1,285 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLLoadCoalescer.h"
+
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+#include "Engine/AssetManager.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "UObject/UObjectGlobals.h"
+
+static TAutoConsoleVariable<bool> CVarAwesomeBLCoalesceLoads(
+	TEXT("AwesomeBL.CoalesceLoads"),
+	true,
+	TEXT("Merge identical in-flight load requests made through the Awesome Blueprint Library into a single streamable request."));
+
+namespace AwesomeBLLoadCoalescer
+{
+	bool LexicalLess(const FSoftObjectPath& A, const FSoftObjectPath& B)
+	{
+		return A.LexicalLess(B);
+	}
+
+	bool LexicalLess(const FPrimaryAssetId& A, const FPrimaryAssetId& B)
+	{
+		if (A.PrimaryAssetType != B.PrimaryAssetType)
+		{
+			return A.PrimaryAssetType.GetName().LexicalLess(B.PrimaryAssetType.GetName());
+		}
+		return A.PrimaryAssetName.LexicalLess(B.PrimaryAssetName);
+	}
+
+	bool LexicalLess(const FName& A, const FName& B)
+	{
+		return A.LexicalLess(B);
+	}
+
+	/** Sort and strip duplicates so the same set of items always produces the same key */
+	template<typename ItemType>
+	uint32 Normalize(TArray<ItemType>& Items, uint32 Hash)
+	{
+		Algo::Sort(Items, [](const ItemType& A, const ItemType& B) { return LexicalLess(A, B); });
+		Items.SetNum(Algo::Unique(Items), false);
+		for (const ItemType& Item : Items)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Item));
+		}
+		return Hash;
+	}
+}
+
+FAwesomeBLLoadCoalescer& FAwesomeBLLoadCoalescer::Get()
+{
+	static FAwesomeBLLoadCoalescer Coalescer;
+	return Coalescer;
+}
+
+TSharedPtr<FStreamableHandle> FAwesomeBLLoadCoalescer::RequestAsyncLoad(TArray<FSoftObjectPath> Paths, FStreamableDelegate OnLoad, TAsyncLoadPriority Priority, FAwesomeBLLoadToken* OutToken)
+{
+	check(IsInGameThread());
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAwesomeBLLoadCoalescer::RequestAsyncLoad);
+
+	FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
+	if (Paths.IsEmpty() || !CVarAwesomeBLCoalesceLoads.GetValueOnGameThread())
+	{
+		TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(MoveTemp(Paths), MoveTemp(OnLoad), Priority);
+		if (OutToken)
+		{
+			*OutToken = { 0, Handle };
+		}
+		return Handle;
+	}
+
+	FRequestKey Key;
+	Key.Paths = MoveTemp(Paths);
+	Key.Hash = AwesomeBLLoadCoalescer::Normalize(Key.Paths, 0);
+
+	TSharedPtr<FInFlightRequest> NewRequest;
+	if (TSharedPtr<FStreamableHandle> ExistingHandle = AddWaiter(MoveTemp(Key), MoveTemp(OnLoad), Priority, NewRequest, OutToken); !NewRequest.IsValid())
+	{
+		return ExistingHandle;
+	}
+
+	const TWeakPtr<FInFlightRequest> WeakRequest = NewRequest;
+	TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(NewRequest->Key.Paths, FStreamableDelegate::CreateLambda([this, WeakRequest]()
+		{
+			if (const TSharedPtr<FInFlightRequest> Request = WeakRequest.Pin())
+			{
+				OnRequestFinished(Request.ToSharedRef(), false);
+			}
+		}), Priority);
+
+	Track(NewRequest, Handle, OutToken);
+	return Handle;
+}
+
+TSharedPtr<FStreamableHandle> FAwesomeBLLoadCoalescer::LoadPrimaryAssets(TConstArrayView<FPrimaryAssetId> PrimaryAssetIds, TConstArrayView<FName> LoadBundles, FStreamableDelegate OnLoad, TAsyncLoadPriority Priority, FAwesomeBLLoadToken* OutToken)
+{
+	check(IsInGameThread());
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAwesomeBLLoadCoalescer::LoadPrimaryAssets);
+
+	UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+	if (!AssetManager)
+	{
+		return nullptr;
+	}
+
+	if (PrimaryAssetIds.IsEmpty() || !CVarAwesomeBLCoalesceLoads.GetValueOnGameThread())
+	{
+		TSharedPtr<FStreamableHandle> Handle = AssetManager->LoadPrimaryAssets(TArray<FPrimaryAssetId>(PrimaryAssetIds), TArray<FName>(LoadBundles), MoveTemp(OnLoad), Priority);
+		if (OutToken)
+		{
+			*OutToken = { 0, Handle };
+		}
+		return Handle;
+	}
+
+	FRequestKey Key;
+	Key.PrimaryAssetIds.Append(PrimaryAssetIds.GetData(), PrimaryAssetIds.Num());
+	Key.LoadBundles.Append(LoadBundles.GetData(), LoadBundles.Num());
+	Key.Hash = AwesomeBLLoadCoalescer::Normalize(Key.LoadBundles, AwesomeBLLoadCoalescer::Normalize(Key.PrimaryAssetIds, 1));
+
+	TSharedPtr<FInFlightRequest> NewRequest;
+	if (TSharedPtr<FStreamableHandle> ExistingHandle = AddWaiter(MoveTemp(Key), MoveTemp(OnLoad), Priority, NewRequest, OutToken); !NewRequest.IsValid())
+	{
+		return ExistingHandle;
+	}
+
+	const TWeakPtr<FInFlightRequest> WeakRequest = NewRequest;
+	TSharedPtr<FStreamableHandle> Handle = AssetManager->LoadPrimaryAssets(NewRequest->Key.PrimaryAssetIds, NewRequest->Key.LoadBundles, FStreamableDelegate::CreateLambda([this, WeakRequest]()
+		{
+			if (const TSharedPtr<FInFlightRequest> Request = WeakRequest.Pin())
+			{
+				OnRequestFinished(Request.ToSharedRef(), false);
+			}
+		}), Priority);
+
+	Track(NewRequest, Handle, OutToken);
+	return Handle;
+}
+
+void FAwesomeBLLoadCoalescer::CancelRequest(const FAwesomeBLLoadToken& Token)
+{
+	check(IsInGameThread());
+
+	if (Token.WaiterId == 0)
+	{
+		// Not merged, the handle is the caller's own.
+		if (const TSharedPtr<FStreamableHandle> Handle = Token.Handle.Pin(); Handle.IsValid() && Handle->IsLoadingInProgress())
+		{
+			Handle->CancelHandle();
+		}
+		return;
+	}
+
+	for (auto It = InFlightRequests.CreateIterator(); It; ++It)
+	{
+		const TSharedRef<FInFlightRequest> Request = It.Value();
+		const int32 Index = Request->Waiters.IndexOfByPredicate([&Token](const FWaiter& Waiter) { return Waiter.Id == Token.WaiterId; });
+		if (Index == INDEX_NONE)
+		{
+			continue;
+		}
+
+		Request->Waiters.RemoveAt(Index);
+		if (Request->Waiters.IsEmpty())
+		{
+			It.RemoveCurrent();
+			if (Request->Handle.IsValid())
+			{
+				Request->Handle->CancelHandle();
+			}
+		}
+		return;
+	}
+
+	// The request has finished already, the caller dropping its handle is enough to release the assets.
+}
+
+void FAwesomeBLLoadCoalescer::ResetStats()
+{
+	NumRequests = 0;
+	NumMergedRequests = 0;
+}
+
+TSharedPtr<FStreamableHandle> FAwesomeBLLoadCoalescer::AddWaiter(FRequestKey&& Key, FStreamableDelegate&& OnLoad, TAsyncLoadPriority Priority, TSharedPtr<FInFlightRequest>& OutNewRequest, FAwesomeBLLoadToken* OutToken)
+{
+	++NumRequests;
+
+	if (const TSharedRef<FInFlightRequest>* Existing = InFlightRequests.Find(Key))
+	{
+		++NumMergedRequests;
+		FInFlightRequest& Request = **Existing;
+		Request.Waiters.Add({ ++LastWaiterId, MoveTemp(OnLoad) });
+		if (OutToken)
+		{
+			*OutToken = { LastWaiterId, Request.Handle };
+		}
+
+		// A real request merging into a low priority prefetch should not wait behind everything else.
+		if (Priority > Request.Priority)
+		{
+			RaisePriority(Request, Priority);
+		}
+		return Request.Handle;
+	}
+
+	const TSharedRef<FInFlightRequest> Request = MakeShared<FInFlightRequest>();
+	Request->Key = MoveTemp(Key);
+	Request->Waiters.Add({ ++LastWaiterId, MoveTemp(OnLoad) });
+	Request->FirstWaiterId = LastWaiterId;
+	Request->Priority = Priority;
+	InFlightRequests.Add(Request->Key, Request);
+
+	OutNewRequest = Request;
+	return nullptr;
+}
+
+void FAwesomeBLLoadCoalescer::Track(const TSharedPtr<FInFlightRequest>& Request, const TSharedPtr<FStreamableHandle>& Handle, FAwesomeBLLoadToken* OutToken)
+{
+	// The first caller's waiter was added before the request started, its delegate may even have run already.
+	if (OutToken)
+	{
+		*OutToken = { Request->FirstWaiterId, Handle };
+	}
+
+	// Keep the handle alive until the waiters got their callback so late joiners share the keep alive as well.
+	Request->Handle = Handle;
+	if (Handle.IsValid() && Handle->IsLoadingInProgress())
+	{
+		const TWeakPtr<FInFlightRequest> WeakRequest = Request;
+		Handle->BindCancelDelegate(FStreamableDelegate::CreateLambda([this, WeakRequest]()
+			{
+				if (const TSharedPtr<FInFlightRequest> CanceledRequest = WeakRequest.Pin())
+				{
+					OnRequestFinished(CanceledRequest.ToSharedRef(), true);
+				}
+			}));
+	}
+}
+
+void FAwesomeBLLoadCoalescer::RaisePriority(FInFlightRequest& Request, TAsyncLoadPriority Priority)
+{
+	Request.Priority = Priority;
+	if (!Request.Handle.IsValid() || !Request.Handle->IsLoadingInProgress())
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> Paths;
+	Request.Handle->GetRequestedAssets(Paths);
+
+	TSet<FName> PackageNames;
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		if (!Path.ResolveObject())
+		{
+			PackageNames.Add(Path.GetLongPackageFName());
+		}
+	}
+	for (const FName& PackageName : PackageNames)
+	{
+		LoadPackageAsync(PackageName.ToString(), FLoadPackageAsyncDelegate(), Priority);
+	}
+}
+
+void FAwesomeBLLoadCoalescer::OnRequestFinished(const TSharedRef<FInFlightRequest>& Request, bool bCanceled)
+{
+	if (const TSharedRef<FInFlightRequest>* Found = InFlightRequests.Find(Request->Key); Found && *Found == Request)
+	{
+		InFlightRequests.Remove(Request->Key);
+	}
+
+	// Waiters may start new loads for the same paths, those should not merge into this finished request.
+	TArray<FWaiter> Waiters = MoveTemp(Request->Waiters);
+	const TSharedPtr<FStreamableHandle> Handle = MoveTemp(Request->Handle);
+
+	if (!bCanceled)
+	{
+		for (const FWaiter& Waiter : Waiters)
+		{
+			Waiter.OnLoad.ExecuteIfBound();
+		}
+	}
+}
@@ -0,0 +1,58 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLLoadRequest.h"
+
+#include "AwesomeBLLoadCoalescer.h"
+
+UAwesomeBLLoadRequest* UAwesomeBLLoadRequest::Create(TSharedPtr<FStreamableHandle> InHandle)
+{
+	UAwesomeBLLoadRequest* Request = NewObject<UAwesomeBLLoadRequest>(GetTransientPackage());
+	Request->Handle = MoveTemp(InHandle);
+	Request->Token.Handle = Request->Handle;
+	return Request;
+}
+
+void UAwesomeBLLoadRequest::Release()
+{
+	// Only drop our reference, the handle releases itself once the last owner lets go of it.
+	Handle.Reset();
+}
+
+void UAwesomeBLLoadRequest::Cancel()
+{
+	// The handle may be shared with merged requests, let the coalescer decide if the load can actually stop.
+	bCanceled = true;
+	FAwesomeBLLoadCoalescer::Get().CancelRequest(Token);
+	Handle.Reset();
+}
+
+bool UAwesomeBLLoadRequest::IsLoadingComplete() const
+{
+	return Handle.IsValid() && Handle->HasLoadCompleted();
+}
+
+bool UAwesomeBLLoadRequest::IsActive() const
+{
+	return Handle.IsValid() && Handle->IsActive();
+}
+
+float UAwesomeBLLoadRequest::GetProgress() const
+{
+	return Handle.IsValid() ? Handle->GetProgress() : 0.f;
+}
+
+void UAwesomeBLLoadRequest::GetLoadedAssets(TArray<UObject*>& LoadedAssets) const
+{
+	LoadedAssets.Reset();
+	if (Handle.IsValid())
+	{
+		Handle->GetLoadedAssets(LoadedAssets);
+	}
+}
+
+void UAwesomeBLLoadRequest::BeginDestroy()
+{
+	Handle.Reset();
+	Super::BeginDestroy();
+}
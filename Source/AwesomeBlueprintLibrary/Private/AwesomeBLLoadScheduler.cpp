@@ -0,0 +1,288 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLLoadScheduler.h"
+
+#include "AwesomeBLLoadStats.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "Misc/CoreDelegates.h"
+
+static TAutoConsoleVariable<bool> CVarAwesomeBLLoadSchedulerEnabled(
+	TEXT("AwesomeBL.LoadScheduler.Enabled"),
+	false,
+	TEXT("Collect the delegate-only async loads of the Awesome Blueprint Library and send them as one batch at the end of the frame."));
+
+static TAutoConsoleVariable<int32> CVarAwesomeBLLoadSchedulerMaxLoadsPerFrame(
+	TEXT("AwesomeBL.LoadScheduler.MaxLoadsPerFrame"),
+	256,
+	TEXT("Maximum number of queued loads sent per frame, 0 for no limit."));
+
+static TAutoConsoleVariable<int32> CVarAwesomeBLLoadSchedulerMaxPathsPerFrame(
+	TEXT("AwesomeBL.LoadScheduler.MaxPathsPerFrame"),
+	1024,
+	TEXT("Maximum number of soft object paths and primary assets sent per frame, 0 for no limit. A single load over budget is still sent on its own."));
+
+UAwesomeBLLoadScheduler* UAwesomeBLLoadScheduler::GetIfEnabled()
+{
+	if (GEngine && CVarAwesomeBLLoadSchedulerEnabled.GetValueOnGameThread())
+	{
+		return GEngine->GetEngineSubsystem<UAwesomeBLLoadScheduler>();
+	}
+	return nullptr;
+}
+
+void UAwesomeBLLoadScheduler::QueueAsyncLoad(TArray<FSoftObjectPath>&& Paths, FStreamableDelegate&& OnLoad, TAsyncLoadPriority Priority, double* OutSendTime)
+{
+	check(IsInGameThread());
+
+	FQueuedLoad& QueuedLoad = QueuedLoads.AddDefaulted_GetRef();
+	QueuedLoad.Paths = MoveTemp(Paths);
+	QueuedLoad.OnLoad = MoveTemp(OnLoad);
+	QueuedLoad.Priority = Priority;
+	QueuedLoad.QueueTime = FPlatformTime::Seconds();
+	QueuedLoad.SendTime = OutSendTime;
+}
+
+void UAwesomeBLLoadScheduler::QueueLoadPrimaryAssets(TConstArrayView<FPrimaryAssetId> PrimaryAssetIds, TConstArrayView<FName> LoadBundles, FStreamableDelegate&& OnLoad, TAsyncLoadPriority Priority, double* OutSendTime)
+{
+	check(IsInGameThread());
+
+	FQueuedLoad& QueuedLoad = QueuedLoads.AddDefaulted_GetRef();
+	QueuedLoad.PrimaryAssetIds.Append(PrimaryAssetIds.GetData(), PrimaryAssetIds.Num());
+	QueuedLoad.LoadBundles.Append(LoadBundles.GetData(), LoadBundles.Num());
+	QueuedLoad.LoadBundles.Sort(FNameLexicalLess());
+	QueuedLoad.OnLoad = MoveTemp(OnLoad);
+	QueuedLoad.Priority = Priority;
+	QueuedLoad.QueueTime = FPlatformTime::Seconds();
+	QueuedLoad.SendTime = OutSendTime;
+}
+
+void UAwesomeBLLoadScheduler::Flush(bool bIgnoreBudget)
+{
+	check(IsInGameThread());
+	TRACE_CPUPROFILER_EVENT_SCOPE(UAwesomeBLLoadScheduler::Flush);
+
+	if (QueuedLoads.IsEmpty())
+	{
+		return;
+	}
+
+	// Stable so loads of equal priority keep the order they were made in.
+	QueuedLoads.StableSort([](const FQueuedLoad& A, const FQueuedLoad& B) { return A.Priority > B.Priority; });
+
+	const int32 MaxLoads = bIgnoreBudget ? 0 : CVarAwesomeBLLoadSchedulerMaxLoadsPerFrame.GetValueOnGameThread();
+	const int32 MaxPaths = bIgnoreBudget ? 0 : CVarAwesomeBLLoadSchedulerMaxPathsPerFrame.GetValueOnGameThread();
+
+	int32 NumLoadsToSend = 0;
+	int32 NumPathsToSend = 0;
+	for (const FQueuedLoad& QueuedLoad : QueuedLoads)
+	{
+		const int32 NumPaths = QueuedLoad.Paths.Num() + QueuedLoad.PrimaryAssetIds.Num();
+		const bool bOverLoadBudget = MaxLoads > 0 && NumLoadsToSend >= MaxLoads;
+		const bool bOverPathBudget = MaxPaths > 0 && NumLoadsToSend > 0 && NumPathsToSend + NumPaths > MaxPaths;
+		if (bOverLoadBudget || bOverPathBudget)
+		{
+			break;
+		}
+		++NumLoadsToSend;
+		NumPathsToSend += NumPaths;
+	}
+
+	TArray<FQueuedLoad> LoadsToSend;
+	LoadsToSend.Reserve(NumLoadsToSend);
+	for (int32 Index = 0; Index < NumLoadsToSend; ++Index)
+	{
+		LoadsToSend.Emplace(MoveTemp(QueuedLoads[Index]));
+	}
+	QueuedLoads.RemoveAt(0, NumLoadsToSend, false);
+
+	const double Now = FPlatformTime::Seconds();
+	const bool bRecordStats = FAwesomeBLLoadStats::IsEnabled();
+	for (const FQueuedLoad& Load : LoadsToSend)
+	{
+		if (Load.SendTime)
+		{
+			*Load.SendTime = Now;
+		}
+		if (bRecordStats)
+		{
+			FAwesomeBLLoadStats::Get().RecordQueueTime(Now - Load.QueueTime);
+		}
+	}
+
+	// Loads are sorted, so the first load of a batch carries its highest priority.
+	FStreamableDelegate OnPathBatchLoaded;
+	TSharedPtr<FBatch> PathBatch;
+	TAsyncLoadPriority PathBatchPriority = FStreamableManager::DefaultAsyncLoadPriority;
+	TSet<FSoftObjectPath> PathBatchTargets;
+
+	struct FPrimaryAssetBatch
+	{
+		TSharedPtr<FBatch> Batch;
+		FStreamableDelegate OnBatchLoaded;
+		TArray<FName> LoadBundles;
+		TSet<FPrimaryAssetId> PrimaryAssetIds;
+		TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority;
+	};
+	TArray<FPrimaryAssetBatch> PrimaryAssetBatches;
+
+	for (FQueuedLoad& Load : LoadsToSend)
+	{
+		if (Load.PrimaryAssetIds.IsEmpty())
+		{
+			if (!PathBatch.IsValid())
+			{
+				PathBatch = MakeBatch(OnPathBatchLoaded);
+				PathBatchPriority = Load.Priority;
+			}
+			PathBatch->Callbacks.Emplace(MoveTemp(Load.OnLoad));
+			PathBatchTargets.Append(Load.Paths);
+			continue;
+		}
+
+		FPrimaryAssetBatch* PrimaryAssetBatch = PrimaryAssetBatches.FindByPredicate([&Load](const FPrimaryAssetBatch& Batch) { return Batch.LoadBundles == Load.LoadBundles; });
+		if (!PrimaryAssetBatch)
+		{
+			PrimaryAssetBatch = &PrimaryAssetBatches.AddDefaulted_GetRef();
+			PrimaryAssetBatch->Batch = MakeBatch(PrimaryAssetBatch->OnBatchLoaded);
+			PrimaryAssetBatch->LoadBundles = MoveTemp(Load.LoadBundles);
+			PrimaryAssetBatch->Priority = Load.Priority;
+		}
+		PrimaryAssetBatch->Batch->Callbacks.Emplace(MoveTemp(Load.OnLoad));
+		PrimaryAssetBatch->PrimaryAssetIds.Append(Load.PrimaryAssetIds);
+	}
+
+	if (PathBatch.IsValid())
+	{
+		if (PathBatchTargets.IsEmpty())
+		{
+			FinishBatch(PathBatch.ToSharedRef());
+		}
+		else
+		{
+			SetBatchHandle(PathBatch.ToSharedRef(), UAssetManager::GetStreamableManager().RequestAsyncLoad(PathBatchTargets.Array(), MoveTemp(OnPathBatchLoaded), PathBatchPriority));
+		}
+	}
+
+	UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+	for (FPrimaryAssetBatch& PrimaryAssetBatch : PrimaryAssetBatches)
+	{
+		if (AssetManager)
+		{
+			// The asset manager still calls the delegate when there is nothing to load.
+			SetBatchHandle(PrimaryAssetBatch.Batch.ToSharedRef(), AssetManager->LoadPrimaryAssets(PrimaryAssetBatch.PrimaryAssetIds.Array(), PrimaryAssetBatch.LoadBundles, MoveTemp(PrimaryAssetBatch.OnBatchLoaded), PrimaryAssetBatch.Priority));
+		}
+		else
+		{
+			// Matches the direct path, which never calls back without an asset manager.
+			InFlightBatches.Remove(PrimaryAssetBatch.Batch.ToSharedRef());
+		}
+	}
+}
+
+void UAwesomeBLLoadScheduler::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddWeakLambda(this, [this]()
+		{
+			Flush();
+		});
+}
+
+void UAwesomeBLLoadScheduler::Deinitialize()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	EndFrameHandle.Reset();
+
+	// Batches in flight outlive us, their delegates only reference the batch from here on.
+	// Batches done loading but waiting for their delayed callback are fanned out right away.
+	const TArray<TSharedRef<FBatch>> Batches = MoveTemp(InFlightBatches);
+	for (const TSharedRef<FBatch>& Batch : Batches)
+	{
+		if (Batch->Handle.IsValid() && Batch->Handle->IsLoadingInProgress())
+		{
+			const FStreamableDelegate OnBatchFinished = FStreamableDelegate::CreateLambda([Batch]()
+				{
+					FanOut(*Batch);
+				});
+			Batch->Handle->BindCompleteDelegate(OnBatchFinished);
+			Batch->Handle->BindCancelDelegate(OnBatchFinished);
+		}
+		else
+		{
+			FanOut(*Batch);
+		}
+	}
+
+	// Don't drop callbacks on the floor, whatever is still queued is sent on its own since no batch will take it.
+	UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+	const double Now = FPlatformTime::Seconds();
+	for (FQueuedLoad& Load : QueuedLoads)
+	{
+		if (Load.SendTime)
+		{
+			*Load.SendTime = Now;
+		}
+		if (Load.PrimaryAssetIds.IsEmpty())
+		{
+			UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(Load.Paths), MoveTemp(Load.OnLoad), Load.Priority);
+		}
+		else if (AssetManager)
+		{
+			AssetManager->LoadPrimaryAssets(Load.PrimaryAssetIds, Load.LoadBundles, MoveTemp(Load.OnLoad), Load.Priority);
+		}
+	}
+	QueuedLoads.Empty();
+
+	Super::Deinitialize();
+}
+
+TSharedRef<UAwesomeBLLoadScheduler::FBatch> UAwesomeBLLoadScheduler::MakeBatch(FStreamableDelegate& OutOnBatchLoaded)
+{
+	const TSharedRef<FBatch> Batch = MakeShared<FBatch>();
+	InFlightBatches.Add(Batch);
+
+	OutOnBatchLoaded = FStreamableDelegate::CreateWeakLambda(this, [this, WeakBatch = TWeakPtr<FBatch>(Batch)]()
+		{
+			if (const TSharedPtr<FBatch> LoadedBatch = WeakBatch.Pin())
+			{
+				FinishBatch(LoadedBatch.ToSharedRef());
+			}
+		});
+	return Batch;
+}
+
+void UAwesomeBLLoadScheduler::SetBatchHandle(const TSharedRef<FBatch>& Batch, TSharedPtr<FStreamableHandle>&& Handle)
+{
+	// Loads that are already done may call back next tick, the handle has to be kept for those as well.
+	if (Handle.IsValid() && Handle->IsLoadingInProgress())
+	{
+		Handle->BindCancelDelegate(FStreamableDelegate::CreateWeakLambda(this, [this, WeakBatch = TWeakPtr<FBatch>(Batch)]()
+		{
+			if (const TSharedPtr<FBatch> CanceledBatch = WeakBatch.Pin())
+			{
+				FinishBatch(CanceledBatch.ToSharedRef());
+			}
+		}));
+	}
+	Batch->Handle = MoveTemp(Handle);
+}
+
+void UAwesomeBLLoadScheduler::FinishBatch(const TSharedRef<FBatch>& Batch)
+{
+	InFlightBatches.Remove(Batch);
+	FanOut(*Batch);
+}
+
+void UAwesomeBLLoadScheduler::FanOut(FBatch& Batch)
+{
+	// Keep the batch handle alive while fanning out so every callback sees the loaded assets.
+	const TSharedPtr<FStreamableHandle> Handle = MoveTemp(Batch.Handle);
+	const TArray<FStreamableDelegate> Callbacks = MoveTemp(Batch.Callbacks);
+	for (const FStreamableDelegate& Callback : Callbacks)
+	{
+		Callback.ExecuteIfBound();
+	}
+}
@@ -0,0 +1,233 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLLoadStats.h"
+
+#include "Algo/BinarySearch.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DEFINE_STAT(STAT_AwesomeBL_LoadCallback);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Loads Completed"), STAT_AwesomeBL_NumLoadsCompleted, STATGROUP_AwesomeBL);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Assets Loaded"), STAT_AwesomeBL_NumAssetsLoaded, STATGROUP_AwesomeBL);
+DECLARE_MEMORY_STAT(TEXT("Bytes Loaded"), STAT_AwesomeBL_BytesLoaded, STATGROUP_AwesomeBL);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Queue Time (ms)"), STAT_AwesomeBL_QueueTime, STATGROUP_AwesomeBL);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Load Time (ms)"), STAT_AwesomeBL_LoadTime, STATGROUP_AwesomeBL);
+
+CSV_DEFINE_CATEGORY(AwesomeBL, true);
+
+static TAutoConsoleVariable<bool> CVarAwesomeBLLoadStatsEnabled(
+	TEXT("AwesomeBL.LoadStats.Enabled"),
+	false,
+	TEXT("Record queue, load and callback times plus loaded bytes per type of the Awesome Blueprint Library loaders. Always off in shipping builds."));
+
+static FAutoConsoleCommandWithOutputDevice AwesomeBLDumpLoadStatsCommand(
+	TEXT("AwesomeBL.DumpLoadStats"),
+	TEXT("Print the latency histograms, per type totals and slowest loads of the Awesome Blueprint Library loaders."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+		{
+			FAwesomeBLLoadStats::Get().Dump(Ar);
+		}));
+
+static FAutoConsoleCommand AwesomeBLResetLoadStatsCommand(
+	TEXT("AwesomeBL.ResetLoadStats"),
+	TEXT("Clear the counters printed by AwesomeBL.DumpLoadStats."),
+	FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FAwesomeBLLoadStats::Get().Reset();
+		}));
+
+namespace AwesomeBLLoadStats
+{
+	/** Number of loads kept by the slowest loads list */
+	constexpr int32 MaxSlowestLoads = 16;
+
+	/** Upper bound of the first histogram bucket, every following bucket doubles it */
+	constexpr double FirstBucketMs = 0.5;
+}
+
+FAwesomeBLLoadStats& FAwesomeBLLoadStats::Get()
+{
+	static FAwesomeBLLoadStats Instance;
+	return Instance;
+}
+
+bool FAwesomeBLLoadStats::IsEnabled()
+{
+#if UE_BUILD_SHIPPING
+	return false;
+#else
+	return CVarAwesomeBLLoadStatsEnabled.GetValueOnGameThread();
+#endif
+}
+
+void FAwesomeBLLoadStats::RecordQueueTime(double Seconds)
+{
+	check(IsInGameThread());
+
+	const double Ms = Seconds * 1000.;
+	QueueTimes.Add(Ms);
+	INC_FLOAT_STAT_BY(STAT_AwesomeBL_QueueTime, static_cast<float>(Ms));
+	CSV_CUSTOM_STAT(AwesomeBL, QueueTimeMaxMs, Ms, ECsvCustomStatOp::Max);
+}
+
+void FAwesomeBLLoadStats::RecordLoadTime(double Seconds, const FSoftObjectPath& FirstPath, int32 InNumAssets)
+{
+	RecordLoadTime(Seconds, InNumAssets, [&FirstPath]() { return FirstPath.ToString(); });
+}
+
+void FAwesomeBLLoadStats::RecordLoadTime(double Seconds, const FPrimaryAssetId& FirstPrimaryAssetId, int32 InNumAssets)
+{
+	RecordLoadTime(Seconds, InNumAssets, [&FirstPrimaryAssetId]() { return FirstPrimaryAssetId.ToString(); });
+}
+
+void FAwesomeBLLoadStats::RecordLoadTime(double Seconds, int32 InNumAssets, TFunctionRef<FString()> Describe)
+{
+	check(IsInGameThread());
+
+	const double Now = FPlatformTime::Seconds();
+	if (NumLoads == 0)
+	{
+		FirstLoadTime = Now - Seconds;
+	}
+	LastLoadTime = Now;
+	++NumLoads;
+
+	const double Ms = Seconds * 1000.;
+	LoadTimes.Add(Ms);
+	INC_DWORD_STAT(STAT_AwesomeBL_NumLoadsCompleted);
+	INC_FLOAT_STAT_BY(STAT_AwesomeBL_LoadTime, static_cast<float>(Ms));
+	CSV_CUSTOM_STAT(AwesomeBL, LoadsCompleted, 1, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(AwesomeBL, LoadTimeMaxMs, Ms, ECsvCustomStatOp::Max);
+
+	// Only describe loads that make it into the list, building the string for every load would cost more than the stat.
+	if (SlowestLoads.Num() < AwesomeBLLoadStats::MaxSlowestLoads || Ms > SlowestLoads.Last().Ms)
+	{
+		if (SlowestLoads.Num() == AwesomeBLLoadStats::MaxSlowestLoads)
+		{
+			SlowestLoads.Pop(false);
+		}
+
+		const int32 InsertIndex = Algo::LowerBound(SlowestLoads, Ms, [](const FSlowLoad& SlowLoad, double Value) { return SlowLoad.Ms > Value; });
+		FString Description = Describe();
+		if (InNumAssets > 1)
+		{
+			Description += FString::Printf(TEXT(" (+%d)"), InNumAssets - 1);
+		}
+		SlowestLoads.Insert({ MoveTemp(Description), Ms }, InsertIndex);
+	}
+}
+
+void FAwesomeBLLoadStats::RecordCallbackTime(double Seconds)
+{
+	check(IsInGameThread());
+
+	CallbackTimes.Add(Seconds * 1000.);
+}
+
+void FAwesomeBLLoadStats::RecordAsset(FName Type, const UObject* Asset)
+{
+	check(IsInGameThread());
+
+	if (!Asset)
+	{
+		return;
+	}
+
+	const int64 Bytes = Asset->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	FTypeStats& Stats = TypeStats.FindOrAdd(Type);
+	++Stats.NumAssets;
+	Stats.Bytes += Bytes;
+	++NumAssets;
+	NumBytes += Bytes;
+
+	INC_DWORD_STAT(STAT_AwesomeBL_NumAssetsLoaded);
+	INC_MEMORY_STAT_BY(STAT_AwesomeBL_BytesLoaded, Bytes);
+	CSV_CUSTOM_STAT(AwesomeBL, AssetsLoaded, 1, ECsvCustomStatOp::Accumulate);
+#if CSV_PROFILER
+	FCsvProfiler::RecordCustomStat(Type, CSV_CATEGORY_INDEX(AwesomeBL), static_cast<float>(Bytes / 1024.), ECsvCustomStatOp::Accumulate);
+#endif
+}
+
+void FAwesomeBLLoadStats::Dump(FOutputDevice& Ar) const
+{
+	const double Duration = LastLoadTime - FirstLoadTime;
+	Ar.Logf(TEXT("AwesomeBL load stats: %lld loads, %lld assets, %.2f MB"), NumLoads, NumAssets, NumBytes / (1024. * 1024.));
+	if (Duration > 0.)
+	{
+		Ar.Logf(TEXT("  Throughput over %.2f s: %.2f loads/s, %.2f assets/s, %.2f MB/s"), Duration, NumLoads / Duration, NumAssets / Duration, NumBytes / (1024. * 1024.) / Duration);
+	}
+
+	QueueTimes.Dump(Ar, TEXT("Queue time"));
+	LoadTimes.Dump(Ar, TEXT("Load time"));
+	CallbackTimes.Dump(Ar, TEXT("Callback time"));
+
+	TArray<FName> Types;
+	TypeStats.GetKeys(Types);
+	Types.Sort([this](const FName& A, const FName& B) { return TypeStats.FindChecked(A).Bytes > TypeStats.FindChecked(B).Bytes; });
+	Ar.Logf(TEXT("  Per type:"));
+	for (const FName& Type : Types)
+	{
+		const FTypeStats& Stats = TypeStats.FindChecked(Type);
+		Ar.Logf(TEXT("    %-32s %8lld assets %10.2f MB"), *Type.ToString(), Stats.NumAssets, Stats.Bytes / (1024. * 1024.));
+	}
+
+	Ar.Logf(TEXT("  Slowest loads:"));
+	for (const FSlowLoad& SlowLoad : SlowestLoads)
+	{
+		Ar.Logf(TEXT("    %10.2f ms %s"), SlowLoad.Ms, *SlowLoad.Description);
+	}
+}
+
+void FAwesomeBLLoadStats::Reset()
+{
+	*this = FAwesomeBLLoadStats();
+}
+
+void FAwesomeBLLoadStats::FHistogram::Add(double Ms)
+{
+	int32 Bucket = 0;
+	if (Ms >= AwesomeBLLoadStats::FirstBucketMs)
+	{
+		Bucket = FMath::Min(1 + FMath::FloorToInt32(FMath::Log2(Ms / AwesomeBLLoadStats::FirstBucketMs)), NumBuckets - 1);
+	}
+
+	++Counts[Bucket];
+	++Num;
+	TotalMs += Ms;
+	MaxMs = FMath::Max(MaxMs, Ms);
+}
+
+void FAwesomeBLLoadStats::FHistogram::Dump(FOutputDevice& Ar, const TCHAR* Name) const
+{
+	Ar.Logf(TEXT("  %s: %u samples, avg %.2f ms, max %.2f ms"), Name, Num, Num > 0 ? TotalMs / Num : 0., MaxMs);
+	if (Num == 0)
+	{
+		return;
+	}
+
+	uint32 MaxCount = 0;
+	for (const uint32 Count : Counts)
+	{
+		MaxCount = FMath::Max(MaxCount, Count);
+	}
+
+	constexpr int32 BarWidth = 40;
+	double LowerMs = 0.;
+	double UpperMs = AwesomeBLLoadStats::FirstBucketMs;
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		const FString Bar = FString::ChrN(static_cast<int32>(static_cast<uint64>(Counts[Bucket]) * BarWidth / MaxCount), TEXT('#'));
+		if (Bucket == NumBuckets - 1)
+		{
+			Ar.Logf(TEXT("    %8.1f+        ms %8u %s"), LowerMs, Counts[Bucket], *Bar);
+		}
+		else
+		{
+			Ar.Logf(TEXT("    %8.1f-%-8.1f ms %8u %s"), LowerMs, UpperMs, Counts[Bucket], *Bar);
+		}
+		LowerMs = UpperMs;
+		UpperMs *= 2.;
+	}
+}
@@ -2,14 +2,36 @@
 
 #include "..\Public\AwesomeBLModule.h"
 
+#include "AwesomeBLAssetSnapshot.h"
+#include "AwesomeBLSyncLoadMonitor.h"
+#include "AwesomeBLWarmUp.h"
+
 #define LOCTEXT_NAMESPACE "FAwesomeBlueprintLibraryModule"
 
+DEFINE_LOG_CATEGORY(LogAwesomeBL);
+
 void FAwesomeBlueprintLibraryModule::StartupModule()
 {
+	// Picks up AwesomeBL.SyncLoadMonitor.Enabled set from config before the module was loaded.
+	if (const IConsoleVariable* SyncLoadMonitorEnabled = IConsoleManager::Get().FindConsoleVariable(TEXT("AwesomeBL.SyncLoadMonitor.Enabled")))
+	{
+		FAwesomeBLSyncLoadMonitor::Get().SetEnabled(SyncLoadMonitorEnabled->GetBool());
+	}
+
+	// The editor and commandlets rescan content that may have changed since the snapshot was written, and have no
+	// loading screen to warm up behind.
+	if (!GIsEditor && !IsRunningCommandlet())
+	{
+		FAwesomeBLAssetSnapshot::Get().Open(FAwesomeBLAssetSnapshot::GetDefaultFilename());
+		FAwesomeBLWarmUp::Get().Start();
+	}
 }
 
 void FAwesomeBlueprintLibraryModule::ShutdownModule()
 {
+	FAwesomeBLSyncLoadMonitor::Get().SetEnabled(false);
+	FAwesomeBLWarmUp::Get().Release();
+	FAwesomeBLAssetSnapshot::Get().Close();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,120 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLNameBatch.h"
+
+namespace AwesomeBLNameBatch
+{
+	/** Below this the local cache costs more than the global name table lookups it saves */
+	constexpr int32 MinNumToCache = 64;
+
+	/**
+	 * Case sensitive, so every casing gets its own lookup. Editor builds preserve the casing a name was made with and
+	 * sharing one name between casings would change the display string compared to constructing each name directly.
+	 */
+	struct FStringViewKeyFuncs : TDefaultMapKeyFuncs<FStringView, FName, false>
+	{
+		static bool Matches(KeyInitType A, KeyInitType B)
+		{
+			return A.Equals(B, ESearchCase::CaseSensitive);
+		}
+
+		static uint32 GetKeyHash(KeyInitType Key)
+		{
+			return FCrc::MemCrc32(Key.GetData(), Key.Len() * sizeof(TCHAR));
+		}
+	};
+}
+
+void FAwesomeBLNameArena::Reset()
+{
+	Views.Reset();
+	Chars.Reset();
+	Ranges.Reset();
+	FirstIndices.Reset();
+}
+
+void FAwesomeBLNameBatch::ToStringViews(TConstArrayView<FName> Names, FAwesomeBLNameArena& Arena)
+{
+	Arena.Reset();
+	Arena.Ranges.Reserve(Names.Num());
+
+	for (const FName& Name : Names)
+	{
+		const TPair<FNameEntryId, int32> Key(Name.GetDisplayIndex(), Name.GetNumber());
+		if (const int32* FirstIndex = Arena.FirstIndices.Find(Key))
+		{
+			Arena.Ranges.Add(Arena.Ranges[*FirstIndex]);
+			continue;
+		}
+
+		Arena.FirstIndices.Add(Key, Arena.Ranges.Num());
+		const int32 Start = Arena.Chars.Len();
+		Name.AppendString(Arena.Chars);
+		Arena.Ranges.Emplace(Start, Arena.Chars.Len() - Start);
+	}
+
+	Arena.Views.Reserve(Arena.Ranges.Num());
+	const TCHAR* Chars = *Arena.Chars;
+	for (const TPair<int32, int32>& Range : Arena.Ranges)
+	{
+		Arena.Views.Emplace(Chars + Range.Key, Range.Value);
+	}
+}
+
+void FAwesomeBLNameBatch::ToStrings(TConstArrayView<FName> Names, TArray<FString>& Target)
+{
+	// Existing strings keep their buffers, ToString(FString&) only reallocates when a name doesn't fit.
+	Target.SetNum(Names.Num());
+	for (int32 Index = 0; Index < Names.Num(); ++Index)
+	{
+		Names[Index].ToString(Target[Index]);
+	}
+}
+
+void FAwesomeBLNameBatch::ToEntryIds(TConstArrayView<FName> Names, TArray<FNameEntryId>& OutEntryIds, TArray<int32>* OutNumbers)
+{
+	OutEntryIds.Reset(Names.Num());
+	if (OutNumbers)
+	{
+		OutNumbers->Reset(Names.Num());
+	}
+
+	for (const FName& Name : Names)
+	{
+		OutEntryIds.Add(Name.GetDisplayIndex());
+		if (OutNumbers)
+		{
+			OutNumbers->Add(Name.GetNumber());
+		}
+	}
+}
+
+void FAwesomeBLNameBatch::ToNames(TConstArrayView<FString> Strings, TArray<FName>& Target, EFindName FindType)
+{
+	Target.Reset(Strings.Num());
+	if (Strings.Num() < AwesomeBLNameBatch::MinNumToCache)
+	{
+		for (const FString& String : Strings)
+		{
+			Target.Emplace(FStringView(String), FindType);
+		}
+		return;
+	}
+
+	// Keys view into Strings, which outlives the cache.
+	TMap<FStringView, FName, FDefaultSetAllocator, AwesomeBLNameBatch::FStringViewKeyFuncs> KnownNames;
+	for (const FString& String : Strings)
+	{
+		const FStringView View(String);
+		if (const FName* KnownName = KnownNames.Find(View))
+		{
+			Target.Add(*KnownName);
+			continue;
+		}
+
+		const FName Name(View, FindType);
+		KnownNames.Add(View, Name);
+		Target.Add(Name);
+	}
+}
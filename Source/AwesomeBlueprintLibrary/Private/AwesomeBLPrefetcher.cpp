@@ -0,0 +1,338 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLPrefetcher.h"
+
+#include "AwesomeBLLoadCoalescer.h"
+#include "AwesomeBLModule.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+
+static FAutoConsoleCommandWithOutputDevice AwesomeBLDumpPrefetchCommand(
+	TEXT("AwesomeBL.DumpPrefetch"),
+	TEXT("Log the prefetch counters and the prefetched assets waiting for their request."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+		{
+			if (const UAwesomeBLPrefetcher* Prefetcher = UAwesomeBLPrefetcher::GetIfEnabled())
+			{
+				Prefetcher->Dump(Ar);
+			}
+			else
+			{
+				Ar.Log(TEXT("Prefetching is disabled"));
+			}
+		}));
+
+namespace AwesomeBLPrefetcher
+{
+	/** Seconds between two checks of the prefetch lifetimes */
+	constexpr float TickInterval = 1.f;
+}
+
+UAwesomeBLPrefetchSettings::UAwesomeBLPrefetchSettings()
+{
+	CategoryName = TEXT("Plugins");
+	SectionName = TEXT("AwesomeBlueprintLibraryPrefetch");
+}
+
+UAwesomeBLPrefetcher* UAwesomeBLPrefetcher::GetIfEnabled()
+{
+	if (GEngine && GetDefault<UAwesomeBLPrefetchSettings>()->bEnabled)
+	{
+		return GEngine->GetEngineSubsystem<UAwesomeBLPrefetcher>();
+	}
+	return nullptr;
+}
+
+void UAwesomeBLPrefetcher::OnTaggedRequest(const FGameplayTagContainer& Tags, TConstArrayView<FPrimaryAssetId> PrimaryAssetIds)
+{
+	check(IsInGameThread());
+
+	const UAwesomeBLPrefetchSettings* Settings = GetDefault<UAwesomeBLPrefetchSettings>();
+	const UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+	if (!AssetManager || Tags.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FPrimaryAssetId> Predictions;
+	for (const FPrimaryAssetId& PrimaryAssetId : PrimaryAssetIds)
+	{
+		// The request has already been made, it keeps the asset loaded from here on.
+		if (FPrefetch Prefetch; Prefetches.RemoveAndCopyValue(PrimaryAssetId, Prefetch))
+		{
+			++Stats.NumHits;
+			Stats.PrefetchedBytes -= Prefetch.Bytes;
+		}
+
+		if (Settings->bLearn)
+		{
+			Learn(Tags, PrimaryAssetId);
+		}
+		Predict(Tags, PrimaryAssetId, Predictions);
+	}
+
+	for (const FPrimaryAssetId& Prediction : Predictions)
+	{
+		if (!PrimaryAssetIds.Contains(Prediction) && !Prefetches.Contains(Prediction) && !AssetManager->GetPrimaryAssetObject(Prediction))
+		{
+			if (Stats.PrefetchedBytes >= static_cast<int64>(Settings->MemoryBudgetMB) * 1024 * 1024 || GetNumInFlight() >= Settings->MaxInFlight)
+			{
+				++Stats.NumOverBudget;
+				continue;
+			}
+			StartPrefetch(Prediction);
+		}
+	}
+}
+
+FAwesomeBLPrefetchStats UAwesomeBLPrefetcher::GetStats() const
+{
+	return Stats;
+}
+
+void UAwesomeBLPrefetcher::ResetStats()
+{
+	const int64 PrefetchedBytes = Stats.PrefetchedBytes;
+	Stats = FAwesomeBLPrefetchStats();
+	Stats.PrefetchedBytes = PrefetchedBytes;
+}
+
+void UAwesomeBLPrefetcher::ForgetLearned()
+{
+	FollowUps.Empty();
+	LastRequested.Empty();
+}
+
+void UAwesomeBLPrefetcher::Dump(FOutputDevice& Ar) const
+{
+	const double HitRate = Stats.NumHits + Stats.NumWasted > 0 ? 100. * Stats.NumHits / (Stats.NumHits + Stats.NumWasted) : 0.;
+	Ar.Logf(TEXT("%d prefetches, %d hits, %d wasted (%.1f%% hit rate), %d over budget, %d learned keys"),
+		Stats.NumPrefetches, Stats.NumHits, Stats.NumWasted, HitRate, Stats.NumOverBudget, FollowUps.Num());
+	Ar.Logf(TEXT("%d prefetched assets waiting for their request, %.2f MB"), Prefetches.Num(), Stats.PrefetchedBytes / (1024. * 1024.));
+
+	const double Now = FPlatformTime::Seconds();
+	for (const TPair<FPrimaryAssetId, FPrefetch>& Pair : Prefetches)
+	{
+		Ar.Logf(TEXT("  %s %s for %.1f s, %.2f MB"), *Pair.Key.ToString(), Pair.Value.Bytes > 0 ? TEXT("loaded") : TEXT("loading"),
+			Now - Pair.Value.StartTime, Pair.Value.Bytes / (1024. * 1024.));
+	}
+}
+
+void UAwesomeBLPrefetcher::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// The hint table loads in the background, hints apply once it is in.
+	const UAwesomeBLPrefetchSettings* Settings = GetDefault<UAwesomeBLPrefetchSettings>();
+	if (Settings->bEnabled && !Settings->HintTable.IsNull())
+	{
+		HintTableHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Settings->HintTable.ToSoftObjectPath());
+	}
+
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UAwesomeBLPrefetcher::Tick), AwesomeBLPrefetcher::TickInterval);
+}
+
+void UAwesomeBLPrefetcher::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+	HintTableHandle.Reset();
+	Prefetches.Empty();
+	FollowUps.Empty();
+	LastRequested.Empty();
+	Super::Deinitialize();
+}
+
+void UAwesomeBLPrefetcher::Learn(const FGameplayTagContainer& Tags, const FPrimaryAssetId& PrimaryAssetId)
+{
+	for (const FGameplayTag& Tag : Tags)
+	{
+		FPrimaryAssetId& Previous = LastRequested.FindOrAdd(Tag);
+		if (Previous.IsValid() && Previous != PrimaryAssetId)
+		{
+			TMap<FPrimaryAssetId, int32>& Counts = FollowUps.FindOrAdd({ Tag, Previous });
+			if (!Counts.Contains(PrimaryAssetId) && Counts.Num() >= MaxFollowUps)
+			{
+				FPrimaryAssetId LeastSeen;
+				int32 LeastCount = MAX_int32;
+				for (const TPair<FPrimaryAssetId, int32>& Count : Counts)
+				{
+					if (Count.Value < LeastCount)
+					{
+						LeastSeen = Count.Key;
+						LeastCount = Count.Value;
+					}
+				}
+				Counts.Remove(LeastSeen);
+			}
+			++Counts.FindOrAdd(PrimaryAssetId);
+		}
+		Previous = PrimaryAssetId;
+	}
+}
+
+void UAwesomeBLPrefetcher::Predict(const FGameplayTagContainer& Tags, const FPrimaryAssetId& PrimaryAssetId, TArray<FPrimaryAssetId>& OutPredictions) const
+{
+	const UAwesomeBLPrefetchSettings* Settings = GetDefault<UAwesomeBLPrefetchSettings>();
+
+	TArray<TPair<FPrimaryAssetId, int32>, TInlineAllocator<MaxFollowUps>> Candidates;
+	for (const FGameplayTag& Tag : Tags)
+	{
+		if (const TMap<FPrimaryAssetId, int32>* Counts = FollowUps.Find({ Tag, PrimaryAssetId }))
+		{
+			Candidates.Reset();
+			for (const TPair<FPrimaryAssetId, int32>& Count : *Counts)
+			{
+				if (Count.Value >= Settings->MinObservations)
+				{
+					Candidates.Add(Count);
+				}
+			}
+			Candidates.Sort([](const TPair<FPrimaryAssetId, int32>& A, const TPair<FPrimaryAssetId, int32>& B) { return A.Value > B.Value; });
+			for (int32 Index = 0; Index < FMath::Min(Candidates.Num(), Settings->MaxPredictions); ++Index)
+			{
+				OutPredictions.AddUnique(Candidates[Index].Key);
+			}
+		}
+	}
+
+	if (const UDataTable* HintTable = Settings->HintTable.Get(); HintTable && HintTable->GetRowStruct() == FAwesomeBLPrefetchHint::StaticStruct())
+	{
+		HintTable->ForeachRow<FAwesomeBLPrefetchHint>(TEXT("UAwesomeBLPrefetcher::Predict"), [&Tags, &PrimaryAssetId, &OutPredictions](const FName&, const FAwesomeBLPrefetchHint& Hint)
+			{
+				if ((!Hint.After.IsValid() || Hint.After == PrimaryAssetId) && Tags.HasAny(Hint.Tags))
+				{
+					for (const FPrimaryAssetId& Prefetch : Hint.Prefetch)
+					{
+						OutPredictions.AddUnique(Prefetch);
+					}
+				}
+			});
+	}
+}
+
+void UAwesomeBLPrefetcher::StartPrefetch(const FPrimaryAssetId& PrimaryAssetId)
+{
+	// Loading the path rather than the primary asset keeps the asset manager from holding it, only the handle does.
+	const UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+	const FSoftObjectPath Path = AssetManager ? AssetManager->GetPrimaryAssetPath(PrimaryAssetId) : FSoftObjectPath();
+	if (Path.IsNull())
+	{
+		return;
+	}
+
+	FPrefetch& Prefetch = Prefetches.Add(PrimaryAssetId);
+	Prefetch.StartTime = FPlatformTime::Seconds();
+	++Stats.NumPrefetches;
+
+	FAwesomeBLLoadToken Token;
+	const TSharedPtr<FStreamableHandle> Handle = FAwesomeBLLoadCoalescer::Get().RequestAsyncLoad({ Path },
+		FStreamableDelegate::CreateUObject(this, &UAwesomeBLPrefetcher::OnPrefetchLoaded, PrimaryAssetId), GetDefault<UAwesomeBLPrefetchSettings>()->Priority, &Token);
+
+	// The delegate may already have run and the prefetch may be gone.
+	if (FPrefetch* Started = Prefetches.Find(PrimaryAssetId))
+	{
+		Started->Handle = Handle;
+		Started->Token = Token;
+	}
+}
+
+void UAwesomeBLPrefetcher::OnPrefetchLoaded(FPrimaryAssetId PrimaryAssetId)
+{
+	FPrefetch* Prefetch = Prefetches.Find(PrimaryAssetId);
+	const UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+	const UObject* Asset = AssetManager ? AssetManager->GetPrimaryAssetObject(PrimaryAssetId) : nullptr;
+	if (!Prefetch)
+	{
+		return;
+	}
+
+	// A failed prefetch would otherwise hold an in-flight slot until it expires.
+	if (!Asset)
+	{
+		DropPrefetch(PrimaryAssetId);
+		return;
+	}
+
+	// Loaded prefetches always count against the budget, even if the estimate comes out empty.
+	Prefetch->Bytes = FMath::Max<int64>(Asset->GetResourceSizeBytes(EResourceSizeMode::Exclusive), 1);
+	Stats.PrefetchedBytes += Prefetch->Bytes;
+	EnforceLimits(static_cast<int64>(GetDefault<UAwesomeBLPrefetchSettings>()->MemoryBudgetMB) * 1024 * 1024);
+}
+
+void UAwesomeBLPrefetcher::EnforceLimits(int64 BudgetBytes)
+{
+	const double ExpireTime = FPlatformTime::Seconds() - GetDefault<UAwesomeBLPrefetchSettings>()->LifetimeSeconds;
+
+	TArray<FPrimaryAssetId> Expired;
+	for (const TPair<FPrimaryAssetId, FPrefetch>& Pair : Prefetches)
+	{
+		if (Pair.Value.StartTime < ExpireTime)
+		{
+			Expired.Add(Pair.Key);
+		}
+	}
+	for (const FPrimaryAssetId& PrimaryAssetId : Expired)
+	{
+		DropPrefetch(PrimaryAssetId);
+	}
+
+	if (Stats.PrefetchedBytes <= BudgetBytes)
+	{
+		return;
+	}
+
+	TArray<TPair<double, FPrimaryAssetId>> Loaded;
+	for (const TPair<FPrimaryAssetId, FPrefetch>& Pair : Prefetches)
+	{
+		if (Pair.Value.Bytes > 0)
+		{
+			Loaded.Emplace(Pair.Value.StartTime, Pair.Key);
+		}
+	}
+	Loaded.Sort([](const TPair<double, FPrimaryAssetId>& A, const TPair<double, FPrimaryAssetId>& B) { return A.Key < B.Key; });
+	for (int32 Index = 0; Index < Loaded.Num() && Stats.PrefetchedBytes > BudgetBytes; ++Index)
+	{
+		DropPrefetch(Loaded[Index].Value);
+	}
+}
+
+void UAwesomeBLPrefetcher::DropPrefetch(const FPrimaryAssetId& PrimaryAssetId)
+{
+	FPrefetch Prefetch;
+	if (!Prefetches.RemoveAndCopyValue(PrimaryAssetId, Prefetch))
+	{
+		return;
+	}
+
+	++Stats.NumWasted;
+	Stats.PrefetchedBytes -= Prefetch.Bytes;
+
+	// Only the prefetch's own hold goes, the handle may be shared with merged requests that still need the asset.
+	FAwesomeBLLoadCoalescer::Get().CancelRequest(Prefetch.Token);
+	Prefetch.Handle.Reset();
+}
+
+int32 UAwesomeBLPrefetcher::GetNumInFlight() const
+{
+	int32 NumInFlight = 0;
+	for (const TPair<FPrimaryAssetId, FPrefetch>& Pair : Prefetches)
+	{
+		if (Pair.Value.Bytes == 0)
+		{
+			++NumInFlight;
+		}
+	}
+	return NumInFlight;
+}
+
+bool UAwesomeBLPrefetcher::Tick(float DeltaTime)
+{
+	if (!Prefetches.IsEmpty())
+	{
+		EnforceLimits(static_cast<int64>(GetDefault<UAwesomeBLPrefetchSettings>()->MemoryBudgetMB) * 1024 * 1024);
+	}
+	return true;
+}
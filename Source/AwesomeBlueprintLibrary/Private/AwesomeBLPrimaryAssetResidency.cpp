@@ -0,0 +1,237 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLPrimaryAssetResidency.h"
+
+#include "AwesomeBLModule.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectGlobals.h"
+
+static FAutoConsoleCommandWithOutputDevice AwesomeBLDumpPrimaryAssetResidencyCommand(
+	TEXT("AwesomeBL.DumpPrimaryAssetResidency"),
+	TEXT("Log the primary assets held through the residency subsystem and who holds them."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+		{
+			if (const UAwesomeBLPrimaryAssetResidency* Residency = UAwesomeBLPrimaryAssetResidency::Get())
+			{
+				Residency->Dump(Ar);
+			}
+		}));
+
+UAwesomeBLPrimaryAssetResidency* UAwesomeBLPrimaryAssetResidency::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UAwesomeBLPrimaryAssetResidency>() : nullptr;
+}
+
+void UAwesomeBLPrimaryAssetResidency::AcquirePrimaryAssets(UObject* Holder, const TArray<FPrimaryAssetId>& PrimaryAssetIds, const TArray<FName>& LoadBundles, int32 Priority)
+{
+	if (!ensureMsgf(Holder, TEXT("Primary assets need a holder to be released with")) || !UAssetManager::GetIfInitialized())
+	{
+		return;
+	}
+
+	for (const FPrimaryAssetId& PrimaryAssetId : PrimaryAssetIds)
+	{
+		Holders.FindOrAdd(PrimaryAssetId).Add({ Holder, LoadBundles, LoadHold(PrimaryAssetId, LoadBundles, Priority) });
+	}
+}
+
+void UAwesomeBLPrimaryAssetResidency::ReleasePrimaryAssets(UObject* Holder, const TArray<FPrimaryAssetId>& PrimaryAssetIds)
+{
+	for (const FPrimaryAssetId& PrimaryAssetId : PrimaryAssetIds)
+	{
+		if (TArray<FHold>* AssetHolders = Holders.Find(PrimaryAssetId))
+		{
+			const int32 Index = AssetHolders->IndexOfByPredicate([Holder](const FHold& Hold) { return Hold.Holder == Holder; });
+			if (Index != INDEX_NONE)
+			{
+				ReleaseHandle((*AssetHolders)[Index].Handle);
+				AssetHolders->RemoveAtSwap(Index, 1, false);
+				if (AssetHolders->IsEmpty())
+				{
+					Holders.Remove(PrimaryAssetId);
+				}
+			}
+		}
+	}
+}
+
+void UAwesomeBLPrimaryAssetResidency::ReleaseAllPrimaryAssets(UObject* Holder)
+{
+	ReleaseHolds([Holder](const FHold& Hold) { return Hold.Holder == Holder; });
+}
+
+void UAwesomeBLPrimaryAssetResidency::ChangeBundleStateForPrimaryAssets(UObject* Holder, const TArray<FPrimaryAssetId>& PrimaryAssetIds, const TArray<FName>& AddBundles, const TArray<FName>& RemoveBundles, int32 Priority)
+{
+	for (const FPrimaryAssetId& PrimaryAssetId : PrimaryAssetIds)
+	{
+		TArray<FHold>* AssetHolders = Holders.Find(PrimaryAssetId);
+		if (!AssetHolders)
+		{
+			continue;
+		}
+
+		for (FHold& Hold : *AssetHolders)
+		{
+			if (Hold.Holder != Holder)
+			{
+				continue;
+			}
+
+			TArray<FName> Bundles = Hold.Bundles;
+			Bundles.RemoveAll([&RemoveBundles](const FName& Bundle) { return RemoveBundles.Contains(Bundle); });
+			for (const FName& Bundle : AddBundles)
+			{
+				Bundles.AddUnique(Bundle);
+			}
+			if (Bundles == Hold.Bundles)
+			{
+				continue;
+			}
+
+			// Request the new content before releasing the old handle, so what both share never unloads in between.
+			TSharedPtr<FStreamableHandle> OldHandle = MoveTemp(Hold.Handle);
+			Hold.Handle = LoadHold(PrimaryAssetId, Bundles, Priority);
+			Hold.Bundles = MoveTemp(Bundles);
+			ReleaseHandle(OldHandle);
+		}
+	}
+}
+
+int32 UAwesomeBLPrimaryAssetResidency::GetReferenceCount(const FPrimaryAssetId& PrimaryAssetId) const
+{
+	int32 Count = 0;
+	if (const TArray<FHold>* AssetHolders = Holders.Find(PrimaryAssetId))
+	{
+		for (const FHold& Hold : *AssetHolders)
+		{
+			Count += Hold.Holder.IsValid() ? 1 : 0;
+		}
+	}
+	return Count;
+}
+
+TArray<FAwesomeBLPrimaryAssetResidencyEntry> UAwesomeBLPrimaryAssetResidency::GetResidencyReport() const
+{
+	const UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+
+	TArray<FAwesomeBLPrimaryAssetResidencyEntry> Report;
+	Report.Reserve(Holders.Num());
+	for (const TPair<FPrimaryAssetId, TArray<FHold>>& Pair : Holders)
+	{
+		FAwesomeBLPrimaryAssetResidencyEntry& Entry = Report.AddDefaulted_GetRef();
+		Entry.PrimaryAssetId = Pair.Key;
+		Entry.bLoaded = AssetManager && AssetManager->GetPrimaryAssetObject(Pair.Key) != nullptr;
+		for (const FHold& Hold : Pair.Value)
+		{
+			if (const UObject* Holder = Hold.Holder.Get())
+			{
+				Entry.Holders.Add(Holder->GetPathName());
+				for (const FName& Bundle : Hold.Bundles)
+				{
+					Entry.Bundles.AddUnique(Bundle);
+				}
+			}
+		}
+		Entry.Bundles.Sort(FNameLexicalLess());
+	}
+
+	Report.Sort([](const FAwesomeBLPrimaryAssetResidencyEntry& A, const FAwesomeBLPrimaryAssetResidencyEntry& B) { return A.PrimaryAssetId.ToString() < B.PrimaryAssetId.ToString(); });
+	return Report;
+}
+
+void UAwesomeBLPrimaryAssetResidency::Dump(FOutputDevice& Ar) const
+{
+	const TArray<FAwesomeBLPrimaryAssetResidencyEntry> Report = GetResidencyReport();
+	Ar.Logf(TEXT("%d primary assets held"), Report.Num());
+	for (const FAwesomeBLPrimaryAssetResidencyEntry& Entry : Report)
+	{
+		TArray<FString> BundleNames;
+		for (const FName& Bundle : Entry.Bundles)
+		{
+			BundleNames.Add(Bundle.ToString());
+		}
+		Ar.Logf(TEXT("  %s %s, bundles [%s], %d holders"), *Entry.PrimaryAssetId.ToString(), Entry.bLoaded ? TEXT("loaded") : TEXT("loading"),
+			*FString::Join(BundleNames, TEXT(", ")), Entry.Holders.Num());
+		for (const FString& Holder : Entry.Holders)
+		{
+			Ar.Logf(TEXT("    %s"), *Holder);
+		}
+	}
+}
+
+void UAwesomeBLPrimaryAssetResidency::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UAwesomeBLPrimaryAssetResidency::PurgeDeadHolders);
+}
+
+void UAwesomeBLPrimaryAssetResidency::Deinitialize()
+{
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	ReleaseHolds([](const FHold&) { return true; });
+	Super::Deinitialize();
+}
+
+void UAwesomeBLPrimaryAssetResidency::PurgeDeadHolders()
+{
+	ReleaseHolds([](const FHold& Hold) { return !Hold.Holder.IsValid(); });
+}
+
+template<typename PredicateType>
+void UAwesomeBLPrimaryAssetResidency::ReleaseHolds(const PredicateType& Predicate)
+{
+	for (auto It = Holders.CreateIterator(); It; ++It)
+	{
+		TArray<FHold>& AssetHolders = It.Value();
+		for (int32 Index = AssetHolders.Num() - 1; Index >= 0; --Index)
+		{
+			if (Predicate(AssetHolders[Index]))
+			{
+				ReleaseHandle(AssetHolders[Index].Handle);
+				AssetHolders.RemoveAtSwap(Index, 1, false);
+			}
+		}
+		if (AssetHolders.IsEmpty())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+TSharedPtr<FStreamableHandle> UAwesomeBLPrimaryAssetResidency::LoadHold(const FPrimaryAssetId& PrimaryAssetId, const TArray<FName>& Bundles, int32 Priority)
+{
+	const UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+	if (!AssetManager)
+	{
+		return nullptr;
+	}
+
+	// The load set is the primary asset plus the content of the bundles, what LoadPrimaryAssets would load.
+	TSet<FSoftObjectPath> LoadSet;
+	AssetManager->GetPrimaryAssetLoadSet(LoadSet, PrimaryAssetId, Bundles, false);
+	if (LoadSet.IsEmpty())
+	{
+		UE_LOG(LogAwesomeBL, Warning, TEXT("Can't hold %s, the asset manager doesn't know it"), *PrimaryAssetId.ToString());
+		return nullptr;
+	}
+	return UAssetManager::GetStreamableManager().RequestAsyncLoad(LoadSet.Array(), FStreamableDelegate(), Priority, false, false, TEXT("AwesomeBLPrimaryAssetResidency"));
+}
+
+void UAwesomeBLPrimaryAssetResidency::ReleaseHandle(TSharedPtr<FStreamableHandle>& Handle)
+{
+	if (Handle.IsValid())
+	{
+		if (Handle->IsLoadingInProgress())
+		{
+			Handle->CancelHandle();
+		}
+		else
+		{
+			Handle->ReleaseHandle();
+		}
+		Handle.Reset();
+	}
+}
@@ -0,0 +1,67 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLProfiling.h"
+
+#include "AwesomeBLModule.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeLock.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+CSV_DECLARE_CATEGORY_EXTERN(AwesomeBL);
+
+namespace AwesomeBLProfiling
+{
+	FCriticalSection OpenScopesCritical;
+
+	/** Start cycles of the open scopes by name, most recently opened last */
+	TMap<FName, TArray<uint64>> OpenScopes;
+
+	int32 NumOpenScopes = 0;
+}
+
+void FAwesomeBLProfiling::BeginScope(FName Name)
+{
+	{
+		FScopeLock Lock(&AwesomeBLProfiling::OpenScopesCritical);
+		AwesomeBLProfiling::OpenScopes.FindOrAdd(Name).Add(FPlatformTime::Cycles64());
+		++AwesomeBLProfiling::NumOpenScopes;
+	}
+
+	TRACE_BEGIN_REGION(*Name.ToString());
+}
+
+void FAwesomeBLProfiling::EndScope(FName Name)
+{
+	uint64 StartCycles = 0;
+	{
+		FScopeLock Lock(&AwesomeBLProfiling::OpenScopesCritical);
+		TArray<uint64>* StartCyclesStack = AwesomeBLProfiling::OpenScopes.Find(Name);
+		if (!StartCyclesStack)
+		{
+			UE_LOG(LogAwesomeBL, Warning, TEXT("Ending profiling scope %s that is not open"), *Name.ToString());
+			return;
+		}
+
+		StartCycles = StartCyclesStack->Pop(false);
+		if (StartCyclesStack->IsEmpty())
+		{
+			AwesomeBLProfiling::OpenScopes.Remove(Name);
+		}
+		--AwesomeBLProfiling::NumOpenScopes;
+	}
+
+	TRACE_END_REGION(*Name.ToString());
+
+#if CSV_PROFILER
+	const float DurationMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+	FCsvProfiler::RecordCustomStat(Name, CSV_CATEGORY_INDEX(AwesomeBL), DurationMs, ECsvCustomStatOp::Accumulate);
+#endif
+}
+
+int32 FAwesomeBLProfiling::GetNumOpenScopes()
+{
+	FScopeLock Lock(&AwesomeBLProfiling::OpenScopesCritical);
+	return AwesomeBLProfiling::NumOpenScopes;
+}
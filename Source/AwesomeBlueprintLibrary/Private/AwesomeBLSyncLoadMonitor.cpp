@@ -0,0 +1,211 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLSyncLoadMonitor.h"
+
+#include "AwesomeBLModule.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/EngineVersionComparison.h"
+#include "UObject/Package.h"
+#include "UObject/Script.h"
+#include "UObject/Stack.h"
+#include "UObject/UObjectGlobals.h"
+
+static TAutoConsoleVariable<bool> CVarAwesomeBLSyncLoadMonitorEnabled(
+	TEXT("AwesomeBL.SyncLoadMonitor.Enabled"),
+	false,
+	TEXT("Record synchronous loads and async loading flushes on the game thread with their Blueprint callstack."),
+	FConsoleVariableDelegate::CreateLambda([](IConsoleVariable* Variable)
+		{
+			FAwesomeBLSyncLoadMonitor::Get().SetEnabled(Variable->GetBool());
+		}));
+
+static TAutoConsoleVariable<float> CVarAwesomeBLSyncLoadMonitorThresholdMs(
+	TEXT("AwesomeBL.SyncLoadMonitor.ThresholdMs"),
+	5.f,
+	TEXT("Sync loads taking longer than this are warned about. Flushes and loads without a known duration are always warned about."));
+
+static TAutoConsoleVariable<float> CVarAwesomeBLSyncLoadMonitorWarningInterval(
+	TEXT("AwesomeBL.SyncLoadMonitor.WarningInterval"),
+	10.f,
+	TEXT("Seconds between two warnings about the same call site."));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice AwesomeBLDumpSyncLoadsCommand(
+	TEXT("AwesomeBL.DumpSyncLoads"),
+	TEXT("Print the slowest sync load and flush call sites recorded by the sync load monitor. Optional argument: number of call sites."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+		{
+			FAwesomeBLSyncLoadMonitor::Get().Dump(Ar, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 20);
+		}));
+
+static FAutoConsoleCommand AwesomeBLResetSyncLoadsCommand(
+	TEXT("AwesomeBL.ResetSyncLoads"),
+	TEXT("Clear the call sites printed by AwesomeBL.DumpSyncLoads."),
+	FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FAwesomeBLSyncLoadMonitor::Get().Reset();
+		}));
+
+namespace AwesomeBLSyncLoadMonitor
+{
+	FString GetCallstack()
+	{
+#if DO_BLUEPRINT_GUARD
+		FString Callstack = FFrame::GetScriptCallstack(true);
+		Callstack.TrimEndInline();
+		return Callstack.IsEmpty() ? TEXT("<native>") : Callstack;
+#else
+		return TEXT("<unavailable>");
+#endif
+	}
+}
+
+FAwesomeBLSyncLoadMonitor& FAwesomeBLSyncLoadMonitor::Get()
+{
+	static FAwesomeBLSyncLoadMonitor Monitor;
+	return Monitor;
+}
+
+void FAwesomeBLSyncLoadMonitor::SetEnabled(bool bEnabled)
+{
+	if (bEnabled == IsEnabled())
+	{
+		return;
+	}
+
+	if (bEnabled)
+	{
+		SyncLoadHandle = FCoreUObjectDelegates::OnSyncLoadPackage.AddRaw(this, &FAwesomeBLSyncLoadMonitor::OnSyncLoadPackage);
+		FlushHandle = FCoreDelegates::OnAsyncLoadingFlush.AddRaw(this, &FAwesomeBLSyncLoadMonitor::OnAsyncLoadingFlush);
+#if UE_VERSION_OLDER_THAN(5, 2, 0)
+		EndLoadPackageHandle = FCoreUObjectDelegates::OnEndLoadPackage.AddRaw(this, &FAwesomeBLSyncLoadMonitor::OnEndLoadPackage);
+#else
+		EndLoadPackageHandle = FCoreUObjectDelegates::OnEndLoadPackage.AddLambda([this](const FEndLoadPackageContext& Context)
+			{
+				OnEndLoadPackage(Context.LoadedPackages);
+			});
+#endif
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FAwesomeBLSyncLoadMonitor::OnEndFrame);
+	}
+	else
+	{
+		FCoreUObjectDelegates::OnSyncLoadPackage.Remove(SyncLoadHandle);
+		FCoreDelegates::OnAsyncLoadingFlush.Remove(FlushHandle);
+		FCoreUObjectDelegates::OnEndLoadPackage.Remove(EndLoadPackageHandle);
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+		SyncLoadHandle.Reset();
+		FlushHandle.Reset();
+		EndLoadPackageHandle.Reset();
+		EndFrameHandle.Reset();
+		PendingLoads.Empty();
+	}
+}
+
+void FAwesomeBLSyncLoadMonitor::Dump(FOutputDevice& Ar, int32 MaxCallSites) const
+{
+	TArray<const FCallSite*> Sorted;
+	Sorted.Reserve(CallSites.Num());
+	for (const TPair<FString, FCallSite>& Pair : CallSites)
+	{
+		Sorted.Add(&Pair.Value);
+	}
+	Sorted.Sort([](const FCallSite& A, const FCallSite& B) { return A.MaxMs != B.MaxMs ? A.MaxMs > B.MaxMs : A.Count > B.Count; });
+
+	Ar.Logf(TEXT("%d sync load call sites%s"), CallSites.Num(), IsEnabled() ? TEXT("") : TEXT(", monitor disabled"));
+	for (int32 Index = 0; Index < FMath::Min(Sorted.Num(), MaxCallSites); ++Index)
+	{
+		const FCallSite& CallSite = *Sorted[Index];
+		Ar.Logf(TEXT("  %s: %d times, %d timed, max %.2f ms, total %.2f ms"), *CallSite.What, CallSite.Count, CallSite.NumTimed, CallSite.MaxMs, CallSite.TotalMs);
+		Ar.Logf(TEXT("    %s"), *CallSite.Callstack.Replace(TEXT("\n"), TEXT("\n    ")));
+	}
+}
+
+void FAwesomeBLSyncLoadMonitor::Reset()
+{
+	CallSites.Empty();
+}
+
+void FAwesomeBLSyncLoadMonitor::OnSyncLoadPackage(const FString& PackageName)
+{
+	if (IsInGameThread())
+	{
+		PendingLoads.Add({ FName(*PackageName), AwesomeBLSyncLoadMonitor::GetCallstack(), FPlatformTime::Seconds() });
+	}
+}
+
+void FAwesomeBLSyncLoadMonitor::OnAsyncLoadingFlush()
+{
+	// The flush only announces its start, so it is recorded without a duration.
+	if (IsInGameThread())
+	{
+		Record(TEXT("FlushAsyncLoading"), AwesomeBLSyncLoadMonitor::GetCallstack(), {});
+	}
+}
+
+void FAwesomeBLSyncLoadMonitor::OnEndLoadPackage(TConstArrayView<UPackage*> LoadedPackages)
+{
+	if (PendingLoads.IsEmpty() || !IsInGameThread())
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	for (const UPackage* Package : LoadedPackages)
+	{
+		const FName PackageName = Package ? Package->GetFName() : NAME_None;
+		const int32 Index = PendingLoads.IndexOfByPredicate([PackageName](const FPendingLoad& PendingLoad) { return PendingLoad.PackageName == PackageName; });
+		if (Index != INDEX_NONE)
+		{
+			const FPendingLoad PendingLoad = MoveTemp(PendingLoads[Index]);
+			PendingLoads.RemoveAt(Index);
+			Record(PendingLoad.PackageName.ToString(), PendingLoad.Callstack, Now - PendingLoad.StartTime);
+		}
+	}
+}
+
+void FAwesomeBLSyncLoadMonitor::OnEndFrame()
+{
+	// Whatever did not report its end within the frame still hitched, but its duration is unknown.
+	for (const FPendingLoad& PendingLoad : PendingLoads)
+	{
+		Record(PendingLoad.PackageName.ToString(), PendingLoad.Callstack, {});
+	}
+	PendingLoads.Reset();
+}
+
+void FAwesomeBLSyncLoadMonitor::Record(const FString& What, const FString& Callstack, TOptional<double> Seconds)
+{
+	FCallSite& CallSite = CallSites.FindOrAdd(What + TEXT("\n") + Callstack);
+	if (CallSite.Count == 0)
+	{
+		CallSite.What = What;
+		CallSite.Callstack = Callstack;
+	}
+	++CallSite.Count;
+
+	const double Now = FPlatformTime::Seconds();
+	const bool bCanWarn = Now - CallSite.LastWarningTime >= CVarAwesomeBLSyncLoadMonitorWarningInterval.GetValueOnGameThread();
+	if (!Seconds.IsSet())
+	{
+		if (bCanWarn)
+		{
+			CallSite.LastWarningTime = Now;
+			UE_LOG(LogAwesomeBL, Warning, TEXT("Sync load of %s on the game thread (%d times so far), use the async loaders instead. Called from:\n%s"),
+				*What, CallSite.Count, *Callstack);
+		}
+		return;
+	}
+
+	const double Ms = Seconds.GetValue() * 1000.;
+	++CallSite.NumTimed;
+	CallSite.TotalMs += Ms;
+	CallSite.MaxMs = FMath::Max(CallSite.MaxMs, Ms);
+
+	if (Ms >= CVarAwesomeBLSyncLoadMonitorThresholdMs.GetValueOnGameThread() && bCanWarn)
+	{
+		CallSite.LastWarningTime = Now;
+		UE_LOG(LogAwesomeBL, Warning, TEXT("Sync load of %s took %.2f ms on the game thread (%d times so far), use the async loaders instead. Called from:\n%s"),
+			*What, Ms, CallSite.Count, *Callstack);
+	}
+}
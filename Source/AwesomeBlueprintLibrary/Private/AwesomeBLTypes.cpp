@@ -3,6 +3,45 @@
 
 #include "AwesomeBLTypes.h"
 
+#include "Async/ParallelFor.h"
+
+namespace AwesomeBLTypes
+{
+	/** Below this many actors a task costs more than the lookups it runs */
+	constexpr int32 MinActorsPerTask = 64;
+
+	/**
+	 * Resolve Reference against every actor. A set OtherActor gives the same component for all of them, so it is
+	 * resolved once. Otherwise workers get a copy without OtherActor, since resolving a soft pointer writes to it.
+	 */
+	template<typename ReferenceType>
+	void GetComponentsFromActors(const ReferenceType& Reference, const TArray<AActor*>& Actors, TArray<UActorComponent*>& OutComponents)
+	{
+		OutComponents.Reset(Actors.Num());
+		OutComponents.AddZeroed(Actors.Num());
+
+		if (Reference.OtherActor.Get())
+		{
+			UActorComponent* Component = Reference.GetComponent(nullptr);
+			for (UActorComponent*& OutComponent : OutComponents)
+			{
+				OutComponent = Component;
+			}
+			return;
+		}
+
+		ReferenceType OwningActorReference = Reference;
+		OwningActorReference.OtherActor.Reset();
+		ParallelFor(TEXT("AwesomeBL.GetComponentsFromActors"), Actors.Num(), MinActorsPerTask, [&OwningActorReference, &Actors, &OutComponents](int32 Index)
+			{
+				if (Actors[Index])
+				{
+					OutComponents[Index] = OwningActorReference.GetComponent(Actors[Index]);
+				}
+			});
+	}
+}
+
 void UAwesomeBLTypes::Conv_ComponentReferenceWrapperToComponentReference(const FComponentReferenceWrapper& Wrapper,
 	FComponentReference& OutComponentReference)
 {
@@ -14,3 +53,13 @@ void UAwesomeBLTypes::Conv_SoftComponentReferenceWrapperToSoftComponentReference
 {
 	OutSoftComponentReference = Wrapper.SoftComponentReference;
 }
+
+void UAwesomeBLTypes::GetComponentsFromActors(const FComponentReferenceWrapper& Wrapper, const TArray<AActor*>& Actors, TArray<UActorComponent*>& OutComponents)
+{
+	AwesomeBLTypes::GetComponentsFromActors(Wrapper.ComponentReference, Actors, OutComponents);
+}
+
+void UAwesomeBLTypes::GetComponentsFromActorsSoft(const FSoftComponentReferenceWrapper& Wrapper, const TArray<AActor*>& Actors, TArray<UActorComponent*>& OutComponents)
+{
+	AwesomeBLTypes::GetComponentsFromActors(Wrapper.SoftComponentReference, Actors, OutComponents);
+}
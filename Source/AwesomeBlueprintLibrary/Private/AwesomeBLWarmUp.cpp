@@ -0,0 +1,137 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLWarmUp.h"
+
+#include "AwesomeBL.h"
+#include "AwesomeBLModule.h"
+#include "Engine/AssetManager.h"
+#include "Misc/CoreDelegates.h"
+
+UAwesomeBLWarmUpSettings::UAwesomeBLWarmUpSettings()
+{
+	CategoryName = TEXT("Plugins");
+	SectionName = TEXT("AwesomeBlueprintLibraryWarmUp");
+}
+
+FAwesomeBLWarmUp& FAwesomeBLWarmUp::Get()
+{
+	static FAwesomeBLWarmUp WarmUp;
+	return WarmUp;
+}
+
+void FAwesomeBLWarmUp::Start()
+{
+	if (bStarted || PostEngineInitHandle.IsValid())
+	{
+		return;
+	}
+
+	// The module starts before the asset manager exists.
+	if (UAssetManager::GetIfInitialized())
+	{
+		RegisterInitialScanCallback();
+	}
+	else
+	{
+		PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddRaw(this, &FAwesomeBLWarmUp::RegisterInitialScanCallback);
+	}
+}
+
+void FAwesomeBLWarmUp::Release()
+{
+	for (FItemState& Item : Items)
+	{
+		Item.Handle.Reset();
+	}
+}
+
+void FAwesomeBLWarmUp::RegisterInitialScanCallback()
+{
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+	PostEngineInitHandle.Reset();
+
+	if (UAssetManager* AssetManager = UAssetManager::GetIfInitialized())
+	{
+		AssetManager->CallOrRegister_OnCompletedInitialScan(FSimpleMulticastDelegate::FDelegate::CreateRaw(this, &FAwesomeBLWarmUp::OnCompletedInitialScan));
+	}
+}
+
+void FAwesomeBLWarmUp::OnCompletedInitialScan()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAwesomeBLWarmUp::OnCompletedInitialScan);
+
+	if (bStarted)
+	{
+		return;
+	}
+	bStarted = true;
+	StartTime = FPlatformTime::Seconds();
+
+	// Whoever waits for the warm-up must not wait forever when there is nothing to warm up.
+	const UAwesomeBLWarmUpSettings* Settings = GetDefault<UAwesomeBLWarmUpSettings>();
+	if (!Settings->bEnabled || Settings->Items.IsEmpty())
+	{
+		OnComplete.Broadcast();
+		return;
+	}
+
+	const UAssetManager& AssetManager = UAssetManager::Get();
+
+	Items.SetNum(Settings->Items.Num());
+	NumPending = Items.Num();
+	for (int32 ItemIndex = 0; ItemIndex < Items.Num(); ++ItemIndex)
+	{
+		const FAwesomeBLWarmUpItem& Config = Settings->Items[ItemIndex];
+		FItemState& Item = Items[ItemIndex];
+		Item.StartTime = FPlatformTime::Seconds();
+
+		TArray<FPrimaryAssetId> PrimaryAssetIds;
+		if (Config.PrimaryAssetType.IsValid())
+		{
+			AssetManager.GetPrimaryAssetIdList(Config.PrimaryAssetType, PrimaryAssetIds);
+		}
+		for (const FPrimaryAssetId& PrimaryAssetId : Config.PrimaryAssetIds)
+		{
+			PrimaryAssetIds.AddUnique(PrimaryAssetId);
+		}
+
+		Item.Name = Config.PrimaryAssetType.IsValid() ? Config.PrimaryAssetType.ToString() : PrimaryAssetIds.Num() > 0 ? PrimaryAssetIds[0].ToString() : FString::Printf(TEXT("Item %d"), ItemIndex);
+		Item.NumAssets = PrimaryAssetIds.Num();
+		Item.ResolveTime = FPlatformTime::Seconds();
+
+		if (PrimaryAssetIds.IsEmpty())
+		{
+			OnItemLoaded(ItemIndex);
+			continue;
+		}
+
+		// Completion comes from the delegate only, a merged or already resident request may have any handle state.
+		const TDelegate<void(const TArray<FPrimaryAssetId>&, const TArray<UObject*>&)> OnLoad = TDelegate<void(const TArray<FPrimaryAssetId>&, const TArray<UObject*>&)>::CreateLambda(
+			[this, ItemIndex](const TArray<FPrimaryAssetId>&, const TArray<UObject*>&)
+			{
+				OnItemLoaded(ItemIndex);
+			});
+		Item.Handle = UAwesomeBL::TRequestAsyncLoadPrimaryAssetList<UObject>(PrimaryAssetIds, Config.LoadBundles, OnLoad, Settings->Priority);
+	}
+}
+
+void FAwesomeBLWarmUp::OnItemLoaded(int32 ItemIndex)
+{
+	FItemState& Item = Items[ItemIndex];
+	if (Item.bDone)
+	{
+		return;
+	}
+	Item.bDone = true;
+
+	const double Now = FPlatformTime::Seconds();
+	UE_LOG(LogAwesomeBL, Log, TEXT("Warm-up %s: %d primary assets in %.2f ms (resolve %.2f ms, load %.2f ms)"), *Item.Name, Item.NumAssets,
+		(Now - Item.StartTime) * 1000., (Item.ResolveTime - Item.StartTime) * 1000., (Now - Item.ResolveTime) * 1000.);
+
+	if (--NumPending == 0)
+	{
+		UE_LOG(LogAwesomeBL, Log, TEXT("Warm-up of %d items finished in %.2f ms"), Items.Num(), (Now - StartTime) * 1000.);
+		OnComplete.Broadcast();
+	}
+}
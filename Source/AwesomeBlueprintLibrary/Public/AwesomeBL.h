@@ -1,11 +1,21 @@
 ﻿#pragma once
 
+#include "AwesomeBLAssetCache.h"
+#include "AwesomeBLIncrementalLoad.h"
+#include "AwesomeBLInputTrack.h"
+#include "AwesomeBLLoadCoalescer.h"
+#include "AwesomeBLLoadFuture.h"
+#include "AwesomeBLLoadRecord.h"
+#include "AwesomeBLLoadScheduler.h"
+#include "AwesomeBLLoadStats.h"
 #include "GameplayTagContainer.h"
 #include "Engine/AssetManager.h"
 #include "kismet/BlueprintFunctionLibrary.h"
 #include "Kismet/GameplayStatics.h"
 #include "AwesomeBL.generated.h"
 
+class UAwesomeBLLoadRequest;
+
 /**
  * Blueprint library designed specifically to extend blueprint functionality. Some of these functions may be
  * useful in cpp but that is not their intent.
@@ -24,6 +34,7 @@ public:
 	DECLARE_DYNAMIC_DELEGATE_ThreeParams(FAsyncLoadPrimaryAssetWithGameplayTags, const FPrimaryAssetId& , PrimaryAssetId, UObject*, LoadedAsset, const FGameplayTagContainer& , GameplayTags);
 	DECLARE_DYNAMIC_DELEGATE_TwoParams(FAsyncLoadPrimaryAssetList, const TArray<FPrimaryAssetId>& , PrimaryAssetIds, const TArray<UObject*>&, LoadedAssets);
 	DECLARE_DYNAMIC_DELEGATE_ThreeParams(FAsyncLoadPrimaryAssetListWithGameplayTags, const TArray<FPrimaryAssetId>& , PrimaryAssetIds, const TArray<UObject*>&, LoadedAssets, const FGameplayTagContainer&, GameplayTags);
+	DECLARE_DYNAMIC_DELEGATE_ThreeParams(FAsyncLoadPrimaryAssetProgress, const FPrimaryAssetId& , PrimaryAssetId, UObject*, LoadedAsset, const FAwesomeBLLoadProgress&, Progress);
 
 	/**
 	 * Gets the FAssetData for a primary asset with the specified type/name, will only work for once that have been scanned for already. Returns true if it found a valid data
@@ -49,6 +60,7 @@ public:
 	 * @param LoadBundles		Bundles to activate with load.
 	 * @param OnLoad			Delegate to call when loading has finished.
 	 * @param Tags				Tags available in delegate call. 
+	 * @note Feeds UAwesomeBLPrefetcher when it is enabled, which may prefetch what usually follows this asset.
 	 */
 	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Loading Helpers", meta = (AutoCreateRefTerm = "LoadBundles"))
 	static void AsyncLoadPrimaryAssetWithTags(const FPrimaryAssetId& AssetToLoad, const TArray<FName>& LoadBundles, const FAsyncLoadPrimaryAssetWithGameplayTags& OnLoad, const FGameplayTagContainer& Tags);
@@ -68,10 +80,43 @@ public:
 	 * @param LoadBundles		Bundles to activate with load.
 	 * @param OnLoad			Delegate to call when loading has finished.
 	 * @param Tags				Tags available in delegate call. 
+	 * @note Feeds UAwesomeBLPrefetcher when it is enabled, which may prefetch what usually follows these assets.
 	 */
 	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Loading Helpers", meta = (AutoCreateRefTerm = "LoadBundles"))
 	static void AsyncLoadPrimaryAssetsWithTags(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, const FAsyncLoadPrimaryAssetListWithGameplayTags& OnLoad, const FGameplayTagContainer& Tags);
 
+	/**
+	 * Loads a PrimaryAsset and keeps it resident until the returned request is released.
+	 * @param AssetToLoad		PrimaryAsset to be loaded.
+	 * @param LoadBundles		Bundles to activate with load.
+	 * @param OnLoad			Delegate to call when loading has finished.
+	 * @param Priority			Priority of the load, higher loads first.
+	 * @return					Request keeping the asset alive, Release or Cancel it when done with the asset.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Loading Helpers", meta = (AutoCreateRefTerm = "LoadBundles"))
+	static UAwesomeBLLoadRequest* RequestAsyncLoadPrimaryAsset(const FPrimaryAssetId& AssetToLoad, const TArray<FName>& LoadBundles, const FAsyncLoadPrimaryAsset& OnLoad, int32 Priority = 0);
+
+	/**
+	 * Loads a list of PrimaryAssets and keeps them resident until the returned request is released.
+	 * @param AssetsToLoad		PrimaryAssets to be loaded.
+	 * @param LoadBundles		Bundles to activate with load.
+	 * @param OnLoad			Delegate to call when loading has finished.
+	 * @param Priority			Priority of the load, higher loads first.
+	 * @return					Request keeping the assets alive, Release or Cancel it when done with the assets.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Loading Helpers", meta = (AutoCreateRefTerm = "LoadBundles"))
+	static UAwesomeBLLoadRequest* RequestAsyncLoadPrimaryAssets(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, const FAsyncLoadPrimaryAssetList& OnLoad, int32 Priority = 0);
+
+	/**
+	 * Loads a list of PrimaryAssets, handing out each asset as soon as it has loaded.
+	 * @param AssetsToLoad		PrimaryAssets to be loaded.
+	 * @param LoadBundles		Bundles to activate with load.
+	 * @param OnAssetLoaded		Delegate to call for each asset as it finishes loading.
+	 * @param OnLoad			Delegate to call once every asset has been handed out.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Loading Helpers", meta = (AutoCreateRefTerm = "LoadBundles"))
+	static void AsyncLoadPrimaryAssetsIncremental(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, const FAsyncLoadPrimaryAssetProgress& OnAssetLoaded, const FAsyncLoadPrimaryAssetList& OnLoad);
+
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~
 	//~~~~	Loading Helpers	~~~~
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -80,6 +125,7 @@ public:
 	DECLARE_DYNAMIC_DELEGATE_TwoParams(FAsyncLoadAssetWithNameTags, UObject*, LoadedAsset, const TArray<FName>&, Tags);
 	DECLARE_DYNAMIC_DELEGATE_OneParam(FAsyncLoadAssetList, const TArray<UObject*>&, LoadedAssets);
 	DECLARE_DYNAMIC_DELEGATE_TwoParams(FAsyncLoadAssetListWithNameTags, const TArray<UObject*>&, LoadedAssets, const TArray<FName>&, Tags);
+	DECLARE_DYNAMIC_DELEGATE_ThreeParams(FAsyncLoadAssetProgress, UObject*, LoadedAsset, int32, Index, const FAwesomeBLLoadProgress&, Progress);
 
 	/**
 	 * Async load a SoftObjectPtr with a bindable delegate.
@@ -114,17 +160,56 @@ public:
 	 */
 	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Loading Helpers", meta = (AutoCreateRefTerm = "Tags"))
 	static void AsyncLoadAssetsWithNameTags(const TArray<TSoftObjectPtr<UObject>>& AssetListToLoad, const TArray<FName>& Tags, const FAsyncLoadAssetListWithNameTags& OnLoad);
+
+	/**
+	 * Async load a SoftObjectPtr and keep it resident until the returned request is released.
+	 * @param AssetToLoad		SoftObjectPtr to be loaded.
+	 * @param OnLoad			Delegate to call when loading has finished.
+	 * @param Priority			Priority of the load, higher loads first.
+	 * @return					Request keeping the asset alive, Release or Cancel it when done with the asset.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Loading Helpers")
+	static UAwesomeBLLoadRequest* RequestAsyncLoadAsset(TSoftObjectPtr<UObject> AssetToLoad, const FAsyncLoadAsset& OnLoad, int32 Priority = 0);
+
+	/**
+	 * Async load a list of SoftObjectPtrs and keep them resident until the returned request is released.
+	 * @param AssetListToLoad	SoftObjectPtr list to be loaded.
+	 * @param OnLoad			Delegate to call when loading has finished.
+	 * @param Priority			Priority of the load, higher loads first.
+	 * @return					Request keeping the assets alive, Release or Cancel it when done with the assets.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Loading Helpers")
+	static UAwesomeBLLoadRequest* RequestAsyncLoadAssets(const TArray<TSoftObjectPtr<UObject>>& AssetListToLoad, const FAsyncLoadAssetList& OnLoad, int32 Priority = 0);
+
+	/**
+	 * Async load a list of SoftObjectPtrs, handing out each asset as soon as it has loaded.
+	 * @param AssetListToLoad	SoftObjectPtr list to be loaded.
+	 * @param OnAssetLoaded		Delegate to call for each asset as it finishes loading, with its index in AssetListToLoad.
+	 * @param OnLoad			Delegate to call once every asset has been handed out.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Loading Helpers")
+	static void AsyncLoadAssetsIncremental(const TArray<TSoftObjectPtr<UObject>>& AssetListToLoad, const FAsyncLoadAssetProgress& OnAssetLoaded, const FAsyncLoadAssetList& OnLoad);
+
+	/**
+	 * Get how many load requests were merged into identical in-flight requests.
+	 * @param NumRequests		Number of requests made since the last reset.
+	 * @param NumMergedRequests	Number of those that did not need a request of their own.
+	 * @param bReset			Reset the counters after reading them.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Loading Helpers")
+	static void GetLoadCoalescingStats(int32& NumRequests, int32& NumMergedRequests, bool bReset = false);
 	
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~
 	//~~~~	Data Helpers	~~~~
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 	/**
-	 * Make a literal GameplayTag from a Name
+	 * Make a literal GameplayTag from a Name. Placed through UK2Node_AwesomeBLLiteralGameplayTag, which bakes literal
+	 * names at compile time and only calls this for connected names.
 	 * @param Tag				The Name of the tag to search for
 	 * @return					Will return the corresponding FGameplayTag or an empty one if not found.
 	 */
-	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Data Helpers", meta = (AutoCreateRefTerm = "Tag"))
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Data Helpers", meta = (AutoCreateRefTerm = "Tag", BlueprintInternalUseOnly = "true"))
 	static FGameplayTag MakeLiteralGameplayTag(const FName& Tag) { return FGameplayTag::RequestGameplayTag(Tag); }
 
 	
@@ -172,6 +257,7 @@ public:
 	
 	/**
 	 * Registers an object to keep alive as long as the GameInstance of the world it lives in is alive
+	 * @note Goes through UAwesomeBLKeepAlive, use it directly for named groups.
 	 * @param WorldContextObject	Object that we can obtain a world context from
 	 * @param Object				Object to register
 	 */
@@ -194,6 +280,21 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|GameInstance Helpers")
 	static void DebugBreak();
 
+	/**
+	 * Open a named profiling scope, visible as a region in Unreal Insights and as a stat in CSV captures. Close it
+	 * with EndProfilingScope using the same name, it may stay open across frames, see FAwesomeBLProfiling.
+	 * @param Name				Name of the scope.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Debug Helpers")
+	static void BeginProfilingScope(FName Name);
+
+	/**
+	 * Close the most recently opened profiling scope with this name.
+	 * @param Name				Name the scope was opened with.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Debug Helpers")
+	static void EndProfilingScope(FName Name);
+
 	//~~~~~~~~~~~~~~~~~~~~
 	//~~~~~   Input   ~~~~
 	//~~~~~~~~~~~~~~~~~~~~
@@ -223,6 +324,50 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Input", meta=(AutoCreateRefTerm=Key))
 	static void InjectControllerButtonReleased(const FKey& Key, const bool bRepeat);
 
+	/** Start recording the key and analog input of every controller, see FAwesomeBLInputTrackPlayer */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Input")
+	static void StartInputRecording();
+
+	/**
+	 * Stop recording input.
+	 * @return					Events recorded since StartInputRecording.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Input")
+	static FAwesomeBLInputTrack StopInputRecording();
+
+	/**
+	 * Inject the events of a track, the ones of each frame in one batch, stopping any track playing.
+	 * @param Track				Track to play.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Input")
+	static void PlayInputTrack(const FAwesomeBLInputTrack& Track);
+
+	/** Stop the track playing */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Input")
+	static void StopInputTrack();
+
+	/** @return Whether a track is playing */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Input")
+	static bool IsPlayingInputTrack();
+
+	/**
+	 * Write a track as JSON.
+	 * @param Track				Track to write.
+	 * @param Filename			File to write, relative to the project directory if not absolute.
+	 * @return					Whether the file was written.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Input")
+	static bool SaveInputTrack(const FAwesomeBLInputTrack& Track, const FString& Filename);
+
+	/**
+	 * Read a track written by SaveInputTrack.
+	 * @param Filename			File to read, relative to the project directory if not absolute.
+	 * @param OutTrack			Track read from the file.
+	 * @return					Whether the file was read.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Input")
+	static bool LoadInputTrack(const FString& Filename, FAwesomeBLInputTrack& OutTrack);
+
 	
 	//~~~~~~~~~~~~~~~~~~~~~~~~~~
 	//~~~~~   Conversions   ~~~~
@@ -246,6 +391,15 @@ public:
 	UFUNCTION(BlueprintPure, DisplayName="Get Component", Category="Awesome Blueprint Library|Conversion", meta=(BlueprintAutocast))
 	static UActorComponent* GetComponentSoft(const FSoftComponentReference& ComponentReference, AActor* OwningActor);
 
+	/**
+	 * Get how often GetComponent and GetComponentSoft were served from the component cache.
+	 * @param NumHits			Number of lookups served from the cache since the last reset.
+	 * @param NumMisses			Number of lookups that had to search the actor.
+	 * @param bReset			Reset the counters after reading them.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Conversion")
+	static void GetComponentCacheStats(int32& NumHits, int32& NumMisses, bool bReset = false);
+
 	/**
 	 * Turn a Name array to a String array
 	 * @param Source			Source array
@@ -299,85 +453,315 @@ public:
 	//~~~~~ Templates ~~~~~
 	//~~~~~~~~~~~~~~~~~~~~~
 	
+	/**
+	 * Async load a list of SoftObjectPtrs and keep them resident for as long as the returned handle is alive.
+	 * @param AssetsToLoad		SoftObjectPtr list to be loaded.
+	 * @param OnLoad			Delegate to call when loading has finished.
+	 * @param Priority			Priority of the load, higher loads first.
+	 * @param OutToken			Optional, set to the token to cancel this request with, see FAwesomeBLLoadCoalescer::CancelRequest.
+	 * @return					Handle to the request, drop it to let the assets GC out.
+	 * @note Identical in-flight requests are merged and share the returned handle, see FAwesomeBLLoadCoalescer.
+	 */
 	template<class Class = UObject>
-	static void TAsyncLoadAssets(const TArray<TSoftObjectPtr<Class>>& AssetsToLoad, const TDelegate<void(const TArray<Class*>&)>& OnLoad)
+	static TSharedPtr<FStreamableHandle> TRequestAsyncLoadAssets(const TArray<TSoftObjectPtr<Class>>& AssetsToLoad, TDelegate<void(const TArray<Class*>&)> OnLoad, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority, FAwesomeBLLoadToken* OutToken = nullptr)
 	{
-		const FStreamableDelegate OnAssetsLoad = FStreamableDelegate::CreateLambda([AssetsToLoad, OnLoad]()
-			{
-				// todo find a better way to convert an array.
-				TArray<Class*> LoadedAssets;
-				LoadedAssets.Reserve(AssetsToLoad.Num());
-				for (const TSoftObjectPtr<Class>& Asset: AssetsToLoad)
-				{
-					if (UObject* LoadedAsset = Asset.Get())
-					{
-						check(Cast<Class>(LoadedAsset));
-						LoadedAssets.Add(Cast<Class>(LoadedAsset));
-					}
-				}
-				
-				OnLoad.ExecuteIfBound(LoadedAssets);
-			});
-		
+		TAwesomeBLLoadRecordRef<TAwesomeBLAssetLoadRecord<Class>> Record = TAcquireAssetLoadRecord<Class>(AssetsToLoad);
+		Record->OnLoad = MoveTemp(OnLoad);
+		return TRequestAssetLoad(MoveTemp(Record), Priority, OutToken);
+	}
+	
+	/**
+	 * Async load a list of SoftObjectPtrs without keeping them resident.
+	 * @note Served from UAwesomeBLAssetCache when every asset is cached, goes through UAwesomeBLLoadScheduler when it is enabled.
+	 */
+	template<class Class = UObject>
+	static void TAsyncLoadAssets(const TArray<TSoftObjectPtr<Class>>& AssetsToLoad, TDelegate<void(const TArray<Class*>&)> OnLoad)
+	{
+		TAwesomeBLLoadRecordRef<TAwesomeBLAssetLoadRecord<Class>> Record = TAcquireAssetLoadRecord<Class>(AssetsToLoad);
+		Record->OnLoad = MoveTemp(OnLoad);
+		TQueueAssetLoad(MoveTemp(Record));
+	}
+	
+	/**
+	 * Async load a list of SoftObjectPtrs, handing out each asset as soon as it has loaded instead of waiting for the slowest one.
+	 * @param AssetsToLoad		SoftObjectPtr list to be loaded.
+	 * @param OnAssetLoaded		Delegate to call for each asset as it finishes loading, with its index in AssetsToLoad.
+	 * @param OnLoad			Delegate to call once every asset has been handed out.
+	 * @param Priority			Priority of the load, higher loads first.
+	 * @return					Handle to the request, drop it to let the assets GC out.
+	 */
+	template<class Class = UObject>
+	static TSharedPtr<FStreamableHandle> TStreamAsyncLoadAssets(const TArray<TSoftObjectPtr<Class>>& AssetsToLoad, const TDelegate<void(int32, Class*, const FAwesomeBLLoadProgress&)>& OnAssetLoaded, TDelegate<void(const TArray<Class*>&)> OnLoad, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
+	{
+		// Null entries are kept so the reported index matches AssetsToLoad.
 		TArray<FSoftObjectPath> SoftObjectPaths;
-		for (const TSoftObjectPtr<>& SoftObjectPointer : AssetsToLoad)
+		SoftObjectPaths.Reserve(AssetsToLoad.Num());
+		for (const TSoftObjectPtr<Class>& SoftObjectPointer : AssetsToLoad)
 		{
-			if (!SoftObjectPointer.IsNull())
+			SoftObjectPaths.Add(SoftObjectPointer.ToSoftObjectPath());
+		}
+
+		TAwesomeBLLoadRecordRef<TAwesomeBLAssetLoadRecord<Class>> Record = TAcquireAssetLoadRecord<Class>(AssetsToLoad);
+		Record->OnLoad = MoveTemp(OnLoad);
+		Record->RequestTime = FPlatformTime::Seconds();
+		return FAwesomeBLIncrementalLoad::RequestAsyncLoad(MoveTemp(SoftObjectPaths), [OnAssetLoaded](int32 Index, UObject* LoadedAsset, const FAwesomeBLLoadProgress& Progress)
 			{
-				SoftObjectPaths.Add(SoftObjectPointer.ToSoftObjectPath());
-			}
+				Class* CastedObject = Cast<Class>(LoadedAsset);
+				check(CastedObject); // Loaded type does not match class
+				OnAssetLoaded.ExecuteIfBound(Index, CastedObject, Progress);
+			}, TMakeOnAssetsLoaded(MoveTemp(Record)), Priority);
+	}
+	
+	template<class Class = UObject>
+	static TSharedPtr<FStreamableHandle> TRequestAsyncLoadAsset(const TSoftObjectPtr<Class> AssetToLoad, TDelegate<void(Class*)> OnLoad, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority, FAwesomeBLLoadToken* OutToken = nullptr)
+	{
+		TAwesomeBLLoadRecordRef<TAwesomeBLAssetLoadRecord<Class>> Record = TAcquireAssetLoadRecord<Class>(MakeArrayView(&AssetToLoad, 1));
+		Record->OnSingleLoad = MoveTemp(OnLoad);
+		return TRequestAssetLoad(MoveTemp(Record), Priority, OutToken);
+	}
+	
+	template<class Class = UObject>
+	static void TAsyncLoadAsset(const TSoftObjectPtr<Class> AssetToLoad, TDelegate<void(Class*)> OnLoad)
+	{
+		TAwesomeBLLoadRecordRef<TAwesomeBLAssetLoadRecord<Class>> Record = TAcquireAssetLoadRecord<Class>(MakeArrayView(&AssetToLoad, 1));
+		Record->OnSingleLoad = MoveTemp(OnLoad);
+		TQueueAssetLoad(MoveTemp(Record));
+	}
+	
+	/**
+	 * Loads a list of PrimaryAssets and keeps them resident for as long as the returned handle is alive.
+	 * @param AssetsToLoad		PrimaryAssets to be loaded.
+	 * @param LoadBundles		Bundles to activate with load.
+	 * @param OnLoad			Delegate to call when loading has finished.
+	 * @param Priority			Priority of the load, higher loads first.
+	 * @param OutToken			Optional, set to the token to cancel this request with, see FAwesomeBLLoadCoalescer::CancelRequest.
+	 * @return					Handle to the request, null if the asset manager is not initialized.
+	 * @note Identical in-flight requests are merged and share the returned handle, see FAwesomeBLLoadCoalescer.
+	 */
+	template<class Class = UObject>
+	static TSharedPtr<FStreamableHandle> TRequestAsyncLoadPrimaryAssetList(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, TDelegate<void(const TArray<FPrimaryAssetId>&, const TArray<Class*>&)> OnLoad, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority, FAwesomeBLLoadToken* OutToken = nullptr)
+	{
+		if (!UAssetManager::GetIfInitialized())
+		{
+			return nullptr;
 		}
-		
-		UAssetManager::GetStreamableManager().RequestAsyncLoad(SoftObjectPaths, OnAssetsLoad);
+
+		TAwesomeBLLoadRecordRef<TAwesomeBLPrimaryAssetLoadRecord<Class>> Record = TAcquirePrimaryAssetLoadRecord<Class>(AssetsToLoad);
+		Record->OnLoad = MoveTemp(OnLoad);
+		return TRequestPrimaryAssetLoad(MoveTemp(Record), LoadBundles, Priority, OutToken);
 	}
 	
+	/**
+	 * Loads a list of PrimaryAssets without holding on to the request.
+	 * @note Goes through UAwesomeBLLoadScheduler when it is enabled.
+	 */
 	template<class Class = UObject>
-	static void TAsyncLoadAsset(const TSoftObjectPtr<Class> AssetToLoad, const TDelegate<void(Class*)>& OnLoad)
+	static void TAsyncLoadPrimaryAssetList(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, TDelegate<void(const TArray<FPrimaryAssetId>&, const TArray<Class*>&)> OnLoad)
 	{
-		TAsyncLoadAssets<Class>(TArray<TSoftObjectPtr<Class>>{ AssetToLoad }, TDelegate<void(const TArray<UObject*>&)>::CreateLambda([OnLoad](const TArray<Class*>& LoadedAssets)
+		if (!UAssetManager::GetIfInitialized())
+		{
+			return;
+		}
+
+		TAwesomeBLLoadRecordRef<TAwesomeBLPrimaryAssetLoadRecord<Class>> Record = TAcquirePrimaryAssetLoadRecord<Class>(AssetsToLoad);
+		Record->OnLoad = MoveTemp(OnLoad);
+		TQueuePrimaryAssetLoad(MoveTemp(Record), LoadBundles);
+	}
+	
+	/**
+	 * Loads a list of PrimaryAssets, handing out each asset as soon as it has loaded instead of waiting for the slowest one.
+	 * @param AssetsToLoad		PrimaryAssets to be loaded.
+	 * @param LoadBundles		Bundles to activate with load.
+	 * @param OnAssetLoaded		Delegate to call for each asset as it finishes loading.
+	 * @param OnLoad			Delegate to call once every asset has been handed out.
+	 * @param Priority			Priority of the load, higher loads first.
+	 * @return					Handle to the request, null if the asset manager is not initialized.
+	 */
+	template<class Class = UObject>
+	static TSharedPtr<FStreamableHandle> TStreamAsyncLoadPrimaryAssetList(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, const TDelegate<void(const FPrimaryAssetId&, Class*, const FAwesomeBLLoadProgress&)>& OnAssetLoaded, TDelegate<void(const TArray<FPrimaryAssetId>&, const TArray<Class*>&)> OnLoad, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
+	{
+		TAwesomeBLLoadRecordRef<TAwesomeBLPrimaryAssetLoadRecord<Class>> Record = TAcquirePrimaryAssetLoadRecord<Class>(AssetsToLoad);
+		Record->OnLoad = MoveTemp(OnLoad);
+		Record->RequestTime = FPlatformTime::Seconds();
+		return FAwesomeBLIncrementalLoad::LoadPrimaryAssets(AssetsToLoad, LoadBundles, [Record, OnAssetLoaded](int32 Index, UObject* LoadedAsset, const FAwesomeBLLoadProgress& Progress)
 			{
-				OnLoad.ExecuteIfBound(LoadedAssets.IsEmpty() ? nullptr : LoadedAssets[0]);
-			}
-			));
+				Class* CastedObject = Cast<Class>(LoadedAsset);
+				check(CastedObject); // Loaded type does not match class
+				OnAssetLoaded.ExecuteIfBound(Record->PrimaryAssetIds[Index], CastedObject, Progress);
+			}, TMakeOnPrimaryAssetsLoaded(Record), Priority);
 	}
 	
 	template<class Class = UObject>
-	static void TAsyncLoadPrimaryAssetList(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, const TDelegate<void(const TArray<FPrimaryAssetId>&, const TArray<Class*>&)>& OnLoad)
+	static TSharedPtr<FStreamableHandle> TRequestAsyncLoadPrimaryAsset(const FPrimaryAssetId& AssetToLoad, const TArray<FName>& LoadBundles, TDelegate<void(const FPrimaryAssetId&, Class*)> OnLoad, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority, FAwesomeBLLoadToken* OutToken = nullptr)
 	{
-		if (UAssetManager* AssetManager = UAssetManager::GetIfInitialized())
+		if (!UAssetManager::GetIfInitialized())
 		{
-			const FStreamableDelegate OnLoadDelegate = FStreamableDelegate::CreateLambda([AssetsToLoad, OnLoad]()
-				{
-					TArray<FPrimaryAssetId> LoadedPrimaryAssets;
-					TArray<Class*> LoadedAssets;
-
-					const UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
-					for (const FPrimaryAssetId& AssetId : AssetsToLoad)
-					{
-						if (UObject* LoadedAsset = AssetManager->GetPrimaryAssetObject(AssetId))
-						{
-							LoadedPrimaryAssets.Emplace(AssetId);
-							Class* CastedObject = Cast<Class>(LoadedAsset);
-							check(CastedObject); // Loaded type does not match class
-							LoadedAssets.Emplace(CastedObject);
-						}
-					}
-					
-					OnLoad.ExecuteIfBound(LoadedPrimaryAssets, LoadedAssets);
-				});
-		
-			AssetManager->LoadPrimaryAssets(AssetsToLoad, LoadBundles, OnLoadDelegate);
+			return nullptr;
 		}
+
+		TAwesomeBLLoadRecordRef<TAwesomeBLPrimaryAssetLoadRecord<Class>> Record = TAcquirePrimaryAssetLoadRecord<Class>(MakeArrayView(&AssetToLoad, 1));
+		Record->OnSingleLoad = MoveTemp(OnLoad);
+		return TRequestPrimaryAssetLoad(MoveTemp(Record), LoadBundles, Priority, OutToken);
 	}
 	
 	template<class Class = UObject>
-	static void TAsyncLoadPrimaryAsset(const FPrimaryAssetId& AssetToLoad, const TArray<FName>& LoadBundles, const TDelegate<void(const FPrimaryAssetId&, Class*)>& OnLoad)
+	static void TAsyncLoadPrimaryAsset(const FPrimaryAssetId& AssetToLoad, const TArray<FName>& LoadBundles, TDelegate<void(const FPrimaryAssetId&, Class*)> OnLoad)
+	{
+		if (!UAssetManager::GetIfInitialized())
+		{
+			return;
+		}
+
+		TAwesomeBLLoadRecordRef<TAwesomeBLPrimaryAssetLoadRecord<Class>> Record = TAcquirePrimaryAssetLoadRecord<Class>(MakeArrayView(&AssetToLoad, 1));
+		Record->OnSingleLoad = MoveTemp(OnLoad);
+		TQueuePrimaryAssetLoad(MoveTemp(Record), LoadBundles);
+	}
+
+	/**
+	 * Future variant of TRequestAsyncLoadAssets. Start several loads, then wait for all of them or chain continuations
+	 * instead of nesting delegates, so independent content loads in parallel.
+	 * @param AssetsToLoad		SoftObjectPtr list to be loaded.
+	 * @param Priority			Priority of the load, higher loads first.
+	 * @return					Future fulfilled on the game thread once loading has finished or was canceled.
+	 */
+	template<class Class = UObject>
+	static TFuture<TAwesomeBLLoadResult<Class>> TLoadAssetsFuture(const TArray<TSoftObjectPtr<Class>>& AssetsToLoad, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
 	{
-		TAsyncLoadPrimaryAssetList(TArray<FPrimaryAssetId>{ AssetToLoad }, LoadBundles, TDelegate<void(const TArray<FPrimaryAssetId>&, const TArray<Class*>&)>::CreateLambda([OnLoad](const TArray<FPrimaryAssetId>& PrimaryAssetIds, const TArray<Class*>& LoadedAssets)
+		const TSharedRef<TAwesomeBLLoadPromise<Class>> Promise = MakeShared<TAwesomeBLLoadPromise<Class>>();
+		TFuture<TAwesomeBLLoadResult<Class>> Future = Promise->GetFuture();
+		// Null and duplicate entries do not make a load fail, so only distinct requested assets are compared.
+		TSet<FSoftObjectPath> Requested;
+		for (const TSoftObjectPtr<Class>& Asset : AssetsToLoad)
+		{
+			if (!Asset.IsNull())
+			{
+				Requested.Add(Asset.ToSoftObjectPath());
+			}
+		}
+		const int32 NumRequested = Requested.Num();
+		Promise->SetHandle(TRequestAsyncLoadAssets<Class>(AssetsToLoad, TDelegate<void(const TArray<Class*>&)>::CreateLambda([Promise, NumRequested](const TArray<Class*>& LoadedAssets)
 			{
-				const FPrimaryAssetId LoadedPrimaryAssets = PrimaryAssetIds.IsEmpty() ? FPrimaryAssetId() : PrimaryAssetIds[0];
-				OnLoad.ExecuteIfBound(LoadedPrimaryAssets, LoadedAssets.IsEmpty() ? nullptr : LoadedAssets[0]);
-			}));
+				Promise->Fulfil(TSet<Class*>(LoadedAssets).Num() == NumRequested, {}, LoadedAssets);
+			}), Priority));
+		return Future;
+	}
+
+	/** Future variant of TRequestAsyncLoadAsset, see TLoadAssetsFuture */
+	template<class Class = UObject>
+	static TFuture<TAwesomeBLLoadResult<Class>> TLoadAssetFuture(const TSoftObjectPtr<Class> AssetToLoad, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
+	{
+		const TSharedRef<TAwesomeBLLoadPromise<Class>> Promise = MakeShared<TAwesomeBLLoadPromise<Class>>();
+		TFuture<TAwesomeBLLoadResult<Class>> Future = Promise->GetFuture();
+		Promise->SetHandle(TRequestAsyncLoadAsset<Class>(AssetToLoad, TDelegate<void(Class*)>::CreateLambda([Promise](Class* LoadedAsset)
+			{
+				Promise->Fulfil(LoadedAsset != nullptr, {}, LoadedAsset ? MakeArrayView(&LoadedAsset, 1) : TArrayView<Class*>());
+			}), Priority));
+		return Future;
+	}
+
+	/** Future variant of TRequestAsyncLoadPrimaryAssetList, see TLoadAssetsFuture */
+	template<class Class = UObject>
+	static TFuture<TAwesomeBLLoadResult<Class>> TLoadPrimaryAssetListFuture(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
+	{
+		const TSharedRef<TAwesomeBLLoadPromise<Class>> Promise = MakeShared<TAwesomeBLLoadPromise<Class>>();
+		TFuture<TAwesomeBLLoadResult<Class>> Future = Promise->GetFuture();
+		// Invalid and duplicate ids do not make a load fail, so only distinct valid ids are compared.
+		TSet<FPrimaryAssetId> Requested;
+		for (const FPrimaryAssetId& PrimaryAssetId : AssetsToLoad)
+		{
+			if (PrimaryAssetId.IsValid())
+			{
+				Requested.Add(PrimaryAssetId);
+			}
+		}
+		const int32 NumRequested = Requested.Num();
+		Promise->SetHandle(TRequestAsyncLoadPrimaryAssetList<Class>(AssetsToLoad, LoadBundles, TDelegate<void(const TArray<FPrimaryAssetId>&, const TArray<Class*>&)>::CreateLambda([Promise, NumRequested](const TArray<FPrimaryAssetId>& LoadedPrimaryAssets, const TArray<Class*>& LoadedAssets)
+			{
+				Promise->Fulfil(TSet<FPrimaryAssetId>(LoadedPrimaryAssets).Num() == NumRequested, LoadedPrimaryAssets, LoadedAssets);
+			}), Priority));
+		return Future;
+	}
+
+	/** Future variant of TRequestAsyncLoadPrimaryAsset, see TLoadAssetsFuture */
+	template<class Class = UObject>
+	static TFuture<TAwesomeBLLoadResult<Class>> TLoadPrimaryAssetFuture(const FPrimaryAssetId& AssetToLoad, const TArray<FName>& LoadBundles, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
+	{
+		const TSharedRef<TAwesomeBLLoadPromise<Class>> Promise = MakeShared<TAwesomeBLLoadPromise<Class>>();
+		TFuture<TAwesomeBLLoadResult<Class>> Future = Promise->GetFuture();
+		Promise->SetHandle(TRequestAsyncLoadPrimaryAsset<Class>(AssetToLoad, LoadBundles, TDelegate<void(const FPrimaryAssetId&, Class*)>::CreateLambda([Promise](const FPrimaryAssetId& LoadedPrimaryAsset, Class* LoadedAsset)
+			{
+				Promise->Fulfil(LoadedAsset != nullptr, LoadedAsset ? MakeArrayView(&LoadedPrimaryAsset, 1) : TArrayView<const FPrimaryAssetId>(),
+					LoadedAsset ? MakeArrayView(&LoadedAsset, 1) : TArrayView<Class*>());
+			}), Priority));
+		return Future;
+	}
+
+	/**
+	 * Task variant of TRequestAsyncLoadAssets, completing once loading has finished. Use it as a prerequisite of
+	 * UE::Tasks::Launch to run dependent work once several loads are in.
+	 * @note Prerequisite tasks run on worker threads, only touch the loaded assets in ways that are safe off the game thread.
+	 */
+	template<class Class = UObject>
+	static UE::Tasks::TTask<TAwesomeBLLoadResult<Class>> TLoadAssetsTask(const TArray<TSoftObjectPtr<Class>>& AssetsToLoad, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
+	{
+		return TToLoadTask(TLoadAssetsFuture<Class>(AssetsToLoad, Priority));
+	}
+
+	/** Task variant of TRequestAsyncLoadAsset, see TLoadAssetsTask */
+	template<class Class = UObject>
+	static UE::Tasks::TTask<TAwesomeBLLoadResult<Class>> TLoadAssetTask(const TSoftObjectPtr<Class> AssetToLoad, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
+	{
+		return TToLoadTask(TLoadAssetFuture<Class>(AssetToLoad, Priority));
+	}
+
+	/** Task variant of TRequestAsyncLoadPrimaryAssetList, see TLoadAssetsTask */
+	template<class Class = UObject>
+	static UE::Tasks::TTask<TAwesomeBLLoadResult<Class>> TLoadPrimaryAssetListTask(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
+	{
+		return TToLoadTask(TLoadPrimaryAssetListFuture<Class>(AssetsToLoad, LoadBundles, Priority));
+	}
+
+	/** Task variant of TRequestAsyncLoadPrimaryAsset, see TLoadAssetsTask */
+	template<class Class = UObject>
+	static UE::Tasks::TTask<TAwesomeBLLoadResult<Class>> TLoadPrimaryAssetTask(const FPrimaryAssetId& AssetToLoad, const TArray<FName>& LoadBundles, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
+	{
+		return TToLoadTask(TLoadPrimaryAssetFuture<Class>(AssetToLoad, LoadBundles, Priority));
+	}
+
+	/**
+	 * Async load a list of SoftObjectPtrs, run a processing step on a worker thread, then hand the loaded assets and
+	 * the processed result out on the game thread. Use it to move parsing, lookup table building or sorting of the
+	 * loaded data off the game thread. The assets stay resident until OnLoad has run.
+	 * @param AssetsToLoad		SoftObjectPtr list to be loaded.
+	 * @param Process			Runs on a worker thread with whether every asset loaded and the loaded assets, must only read them in thread safe ways.
+	 * @param OnLoad			Delegate to call on the game thread with whether every asset loaded, the loaded assets and the result of Process, which may be moved from.
+	 * @param Priority			Priority of the load, higher loads first.
+	 */
+	template<class Class, typename ProcessedType>
+	static void TAsyncLoadAssetsProcessed(const TArray<TSoftObjectPtr<Class>>& AssetsToLoad, TUniqueFunction<ProcessedType(bool, const TArray<Class*>&)> Process, TDelegate<void(bool, const TArray<Class*>&, ProcessedType&)> OnLoad, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
+	{
+		TProcessOnWorker<Class, ProcessedType>(TLoadAssetsFuture<Class>(AssetsToLoad, Priority), MoveTemp(Process), [OnLoad = MoveTemp(OnLoad)](const TAwesomeBLLoadResult<Class>& Loaded, ProcessedType& Processed)
+			{
+				OnLoad.ExecuteIfBound(Loaded.bSuccess, Loaded.Assets, Processed);
+			});
+	}
+
+	/**
+	 * Loads a list of PrimaryAssets, runs a processing step on a worker thread, then hands the loaded assets and the
+	 * processed result out on the game thread, see TAsyncLoadAssetsProcessed.
+	 * @param AssetsToLoad		PrimaryAssets to be loaded.
+	 * @param LoadBundles		Bundles to activate with load.
+	 * @param Process			Runs on a worker thread with whether every asset loaded and the loaded assets, must only read them in thread safe ways.
+	 * @param OnLoad			Delegate to call on the game thread with whether every asset loaded, the loaded assets and the result of Process, which may be moved from.
+	 * @param Priority			Priority of the load, higher loads first.
+	 */
+	template<class Class, typename ProcessedType>
+	static void TAsyncLoadPrimaryAssetListProcessed(const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, TUniqueFunction<ProcessedType(bool, const TArray<Class*>&)> Process, TDelegate<void(bool, const TArray<FPrimaryAssetId>&, const TArray<Class*>&, ProcessedType&)> OnLoad, const TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
+	{
+		TProcessOnWorker<Class, ProcessedType>(TLoadPrimaryAssetListFuture<Class>(AssetsToLoad, LoadBundles, Priority), MoveTemp(Process), [OnLoad = MoveTemp(OnLoad)](const TAwesomeBLLoadResult<Class>& Loaded, ProcessedType& Processed)
+			{
+				OnLoad.ExecuteIfBound(Loaded.bSuccess, Loaded.PrimaryAssetIds, Loaded.Assets, Processed);
+			});
 	}
 
 	/** Assumes implicit conversion */
@@ -387,4 +771,240 @@ public:
 		Target.Reset(Source.Num());
 		Target.Append(Source);
 	}
+
+private:
+
+	/** Make a task that completes with the result of a load future, held back by an event until the future is fulfilled */
+	template<class Class>
+	static UE::Tasks::TTask<TAwesomeBLLoadResult<Class>> TToLoadTask(TFuture<TAwesomeBLLoadResult<Class>>&& Future)
+	{
+		UE::Tasks::FTaskEvent Loaded(UE_SOURCE_LOCATION);
+		const TSharedRef<TAwesomeBLLoadResult<Class>> Result = MakeShared<TAwesomeBLLoadResult<Class>>();
+		Future.Then([Loaded, Result](TFuture<TAwesomeBLLoadResult<Class>>&& Completed) mutable
+			{
+				*Result = Completed.Consume();
+				Loaded.Trigger();
+			});
+		return UE::Tasks::Launch(UE_SOURCE_LOCATION, [Result]() { return MoveTemp(*Result); }, Loaded);
+	}
+
+	/**
+	 * Once the future is fulfilled run Process on a worker, then Deliver on the game thread. Both run for failed or
+	 * canceled loads too, with bSuccess false. The result, and with it the handle keeping the assets resident, lives
+	 * until Deliver has run.
+	 */
+	template<class Class, typename ProcessedType, typename DeliverType>
+	static void TProcessOnWorker(TFuture<TAwesomeBLLoadResult<Class>>&& Future, TUniqueFunction<ProcessedType(bool, const TArray<Class*>&)>&& Process, DeliverType&& Deliver)
+	{
+		Future.Then([Process = MoveTemp(Process), Deliver = MoveTemp(Deliver)](TFuture<TAwesomeBLLoadResult<Class>>&& Completed) mutable
+			{
+				UE::Tasks::Launch(UE_SOURCE_LOCATION, [Loaded = Completed.Consume(), Process = MoveTemp(Process), Deliver = MoveTemp(Deliver)]() mutable
+					{
+						TRACE_CPUPROFILER_EVENT_SCOPE(UAwesomeBL::ProcessLoaded);
+						ProcessedType Processed = Process(Loaded.bSuccess, Loaded.Assets);
+						AsyncTask(ENamedThreads::GameThread, [Loaded = MoveTemp(Loaded), Processed = MoveTemp(Processed), Deliver = MoveTemp(Deliver)]() mutable
+							{
+								SCOPE_CYCLE_COUNTER(STAT_AwesomeBL_LoadCallback);
+								Deliver(Loaded, Processed);
+							});
+					});
+			});
+	}
+
+	/** Take a pooled record for a soft object load */
+	template<class Class>
+	static TAwesomeBLLoadRecordRef<TAwesomeBLAssetLoadRecord<Class>> TAcquireAssetLoadRecord(TConstArrayView<TSoftObjectPtr<Class>> AssetsToLoad)
+	{
+		TAwesomeBLLoadRecordRef<TAwesomeBLAssetLoadRecord<Class>> Record = TAwesomeBLLoadRecordRef<TAwesomeBLAssetLoadRecord<Class>>::Acquire();
+		Record->Assets.Append(AssetsToLoad.GetData(), AssetsToLoad.Num());
+		return Record;
+	}
+
+	/** Take a pooled record for a primary asset load */
+	template<class Class>
+	static TAwesomeBLLoadRecordRef<TAwesomeBLPrimaryAssetLoadRecord<Class>> TAcquirePrimaryAssetLoadRecord(TConstArrayView<FPrimaryAssetId> AssetsToLoad)
+	{
+		TAwesomeBLLoadRecordRef<TAwesomeBLPrimaryAssetLoadRecord<Class>> Record = TAwesomeBLLoadRecordRef<TAwesomeBLPrimaryAssetLoadRecord<Class>>::Acquire();
+		Record->PrimaryAssetIds.Append(AssetsToLoad.GetData(), AssetsToLoad.Num());
+		return Record;
+	}
+
+	/** Request a soft object load that keeps the assets resident through the returned handle */
+	template<class Class>
+	static TSharedPtr<FStreamableHandle> TRequestAssetLoad(TAwesomeBLLoadRecordRef<TAwesomeBLAssetLoadRecord<Class>>&& Record, const TAsyncLoadPriority Priority, FAwesomeBLLoadToken* OutToken = nullptr)
+	{
+		TArray<FSoftObjectPath> SoftObjectPaths = Record->GatherSoftObjectPaths();
+		Record->RequestTime = FPlatformTime::Seconds();
+		return FAwesomeBLLoadCoalescer::Get().RequestAsyncLoad(MoveTemp(SoftObjectPaths), TMakeOnAssetsLoaded(MoveTemp(Record)), Priority, OutToken);
+	}
+
+	/**
+	 * Serve a soft object load from the asset cache, the scheduler or the coalescer, whichever applies first.
+	 * The request time is stamped once the load is sent, cache hits leave it unset and are counted by the cache instead.
+	 */
+	template<class Class>
+	static void TQueueAssetLoad(TAwesomeBLLoadRecordRef<TAwesomeBLAssetLoadRecord<Class>>&& Record)
+	{
+		// Cache hits check the record's paths in place, only loads that are sent need their own copy.
+		const TArray<FSoftObjectPath>& RecordPaths = Record->GatherSoftObjectPaths();
+		if (UAwesomeBLAssetCache* Cache = UAwesomeBLAssetCache::GetIfEnabled(); Cache && Cache->TryUseAssets(RecordPaths))
+		{
+			UAwesomeBLAssetCache::ExecuteNextTick(TMakeOnAssetsLoaded(MoveTemp(Record)));
+			return;
+		}
+
+		TArray<FSoftObjectPath> SoftObjectPaths = RecordPaths;
+
+		if (UAwesomeBLLoadScheduler* Scheduler = UAwesomeBLLoadScheduler::GetIfEnabled())
+		{
+			// The record lives in its pool node for as long as the delegate holds it.
+			double* const SendTime = &Record->RequestTime;
+			Scheduler->QueueAsyncLoad(MoveTemp(SoftObjectPaths), TMakeOnAssetsLoaded(MoveTemp(Record)), FStreamableManager::DefaultAsyncLoadPriority, SendTime);
+			return;
+		}
+		
+		Record->RequestTime = FPlatformTime::Seconds();
+		FAwesomeBLLoadCoalescer::Get().RequestAsyncLoad(MoveTemp(SoftObjectPaths), TMakeOnAssetsLoaded(MoveTemp(Record)), FStreamableManager::DefaultAsyncLoadPriority);
+	}
+
+	/** Request a primary asset load that keeps the assets resident through the returned handle */
+	template<class Class>
+	static TSharedPtr<FStreamableHandle> TRequestPrimaryAssetLoad(TAwesomeBLLoadRecordRef<TAwesomeBLPrimaryAssetLoadRecord<Class>>&& Record, const TArray<FName>& LoadBundles, const TAsyncLoadPriority Priority, FAwesomeBLLoadToken* OutToken = nullptr)
+	{
+		// The record lives in its pool node, moving the reference into the delegate keeps the view valid.
+		const TConstArrayView<FPrimaryAssetId> PrimaryAssetIds = Record->PrimaryAssetIds;
+		Record->RequestTime = FPlatformTime::Seconds();
+		return FAwesomeBLLoadCoalescer::Get().LoadPrimaryAssets(PrimaryAssetIds, LoadBundles, TMakeOnPrimaryAssetsLoaded(MoveTemp(Record)), Priority, OutToken);
+	}
+
+	/** Send a primary asset load through the scheduler when it is enabled, the coalescer otherwise */
+	template<class Class>
+	static void TQueuePrimaryAssetLoad(TAwesomeBLLoadRecordRef<TAwesomeBLPrimaryAssetLoadRecord<Class>>&& Record, const TArray<FName>& LoadBundles)
+	{
+		if (UAwesomeBLLoadScheduler* Scheduler = UAwesomeBLLoadScheduler::GetIfEnabled())
+		{
+			const TConstArrayView<FPrimaryAssetId> PrimaryAssetIds = Record->PrimaryAssetIds;
+			double* const SendTime = &Record->RequestTime;
+			Scheduler->QueueLoadPrimaryAssets(PrimaryAssetIds, LoadBundles, TMakeOnPrimaryAssetsLoaded(MoveTemp(Record)), FStreamableManager::DefaultAsyncLoadPriority, SendTime);
+			return;
+		}
+
+		TRequestPrimaryAssetLoad(MoveTemp(Record), LoadBundles, FStreamableManager::DefaultAsyncLoadPriority);
+	}
+
+	/**
+	 * Make the streamable delegate resolving the loaded SoftObjectPtrs of a record for its delegate, loaded assets are
+	 * added to the asset cache. Load and callback times plus loaded assets per class are recorded in FAwesomeBLLoadStats.
+	 */
+	template<class Class>
+	static FStreamableDelegate TMakeOnAssetsLoaded(TAwesomeBLLoadRecordRef<TAwesomeBLAssetLoadRecord<Class>> Record)
+	{
+		return FStreamableDelegate::CreateLambda([Record = MoveTemp(Record)]()
+			{
+				TRACE_CPUPROFILER_EVENT_SCOPE(UAwesomeBL::OnAssetsLoaded);
+				const TArray<TSoftObjectPtr<Class>, TInlineAllocator<1>>& AssetsToLoad = Record->Assets;
+				const bool bRecordStats = FAwesomeBLLoadStats::IsEnabled() && !AssetsToLoad.IsEmpty();
+				const double LoadedTime = FPlatformTime::Seconds();
+				if (bRecordStats && Record->RequestTime > 0.)
+				{
+					FAwesomeBLLoadStats::Get().RecordLoadTime(LoadedTime - Record->RequestTime, AssetsToLoad[0].ToSoftObjectPath(), AssetsToLoad.Num());
+				}
+
+				UAwesomeBLAssetCache* Cache = UAwesomeBLAssetCache::GetIfEnabled();
+				
+				TArray<Class*>& LoadedAssets = Record->LoadedAssets;
+				LoadedAssets.Reset(AssetsToLoad.Num());
+				for (const TSoftObjectPtr<Class>& Asset: AssetsToLoad)
+				{
+					if (UObject* LoadedAsset = Asset.Get())
+					{
+						check(Cast<Class>(LoadedAsset));
+						LoadedAssets.Add(Cast<Class>(LoadedAsset));
+						if (Cache)
+						{
+							Cache->AddAsset(Asset.ToSoftObjectPath(), LoadedAsset);
+						}
+						if (bRecordStats)
+						{
+							FAwesomeBLLoadStats::Get().RecordAsset(LoadedAsset->GetClass()->GetFName(), LoadedAsset);
+						}
+					}
+				}
+				
+				{
+					SCOPE_CYCLE_COUNTER(STAT_AwesomeBL_LoadCallback);
+					const double CallbackStartTime = FPlatformTime::Seconds();
+					if (Record->OnSingleLoad.IsBound())
+					{
+						Record->OnSingleLoad.Execute(LoadedAssets.IsEmpty() ? nullptr : LoadedAssets[0]);
+					}
+					else
+					{
+						Record->OnLoad.ExecuteIfBound(LoadedAssets);
+					}
+					if (bRecordStats)
+					{
+						FAwesomeBLLoadStats::Get().RecordCallbackTime(FPlatformTime::Seconds() - CallbackStartTime);
+					}
+				}
+			});
+	}
+
+	/**
+	 * Make the streamable delegate resolving the loaded PrimaryAssets of a record for its delegate.
+	 * Load and callback times plus loaded assets per primary asset type are recorded in FAwesomeBLLoadStats.
+	 */
+	template<class Class>
+	static FStreamableDelegate TMakeOnPrimaryAssetsLoaded(TAwesomeBLLoadRecordRef<TAwesomeBLPrimaryAssetLoadRecord<Class>> Record)
+	{
+		return FStreamableDelegate::CreateLambda([Record = MoveTemp(Record)]()
+			{
+				TRACE_CPUPROFILER_EVENT_SCOPE(UAwesomeBL::OnPrimaryAssetsLoaded);
+				const TArray<FPrimaryAssetId, TInlineAllocator<1>>& AssetsToLoad = Record->PrimaryAssetIds;
+				const bool bRecordStats = FAwesomeBLLoadStats::IsEnabled() && !AssetsToLoad.IsEmpty();
+				const double LoadedTime = FPlatformTime::Seconds();
+				if (bRecordStats && Record->RequestTime > 0.)
+				{
+					FAwesomeBLLoadStats::Get().RecordLoadTime(LoadedTime - Record->RequestTime, AssetsToLoad[0], AssetsToLoad.Num());
+				}
+
+				TArray<FPrimaryAssetId>& LoadedPrimaryAssets = Record->LoadedPrimaryAssetIds;
+				TArray<Class*>& LoadedAssets = Record->LoadedAssets;
+				LoadedPrimaryAssets.Reset(AssetsToLoad.Num());
+				LoadedAssets.Reset(AssetsToLoad.Num());
+
+				const UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+				for (const FPrimaryAssetId& AssetId : AssetsToLoad)
+				{
+					if (UObject* LoadedAsset = AssetManager->GetPrimaryAssetObject(AssetId))
+					{
+						LoadedPrimaryAssets.Emplace(AssetId);
+						Class* CastedObject = Cast<Class>(LoadedAsset);
+						check(CastedObject); // Loaded type does not match class
+						LoadedAssets.Emplace(CastedObject);
+						if (bRecordStats)
+						{
+							FAwesomeBLLoadStats::Get().RecordAsset(AssetId.PrimaryAssetType.GetName(), LoadedAsset);
+						}
+					}
+				}
+				
+				{
+					SCOPE_CYCLE_COUNTER(STAT_AwesomeBL_LoadCallback);
+					const double CallbackStartTime = FPlatformTime::Seconds();
+					if (Record->OnSingleLoad.IsBound())
+					{
+						Record->OnSingleLoad.Execute(LoadedPrimaryAssets.IsEmpty() ? FPrimaryAssetId() : LoadedPrimaryAssets[0], LoadedAssets.IsEmpty() ? nullptr : LoadedAssets[0]);
+					}
+					else
+					{
+						Record->OnLoad.ExecuteIfBound(LoadedPrimaryAssets, LoadedAssets);
+					}
+					if (bRecordStats)
+					{
+						FAwesomeBLLoadStats::Get().RecordCallbackTime(FPlatformTime::Seconds() - CallbackStartTime);
+					}
+				}
+			});
+	}
 };
\ No newline at end of file
@@ -0,0 +1,253 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "AwesomeBLArrayMath.generated.h"
+
+/** How floats are turned into integers */
+UENUM(BlueprintType)
+enum class EAwesomeBLRoundingMode : uint8
+{
+	/** Toward zero, the same as a C++ cast */
+	Truncate,
+	/** Toward negative infinity */
+	Floor,
+	/** Toward positive infinity */
+	Ceil,
+	/** To the nearest integer, halves toward positive infinity like FMath::RoundToInt */
+	Round,
+	/** To the nearest integer, halves to the nearest even integer */
+	RoundHalfToEven,
+};
+
+/**
+ * Numeric array math on whole arrays at once, four lanes at a time through VectorRegister. Meant to replace Blueprint
+ * loops over large arrays. In place variants write into the array passed by reference and never allocate.
+ * Binary operations work on the length of the shorter array.
+ */
+UCLASS(meta=(BlueprintThreadSafe))
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLArrayMath : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+
+	//~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//~~~~~   Conversions   ~~~~
+	//~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+	/**
+	 * Turn an Int array into a Float array
+	 * @param Source			Source array
+	 * @param Target			Target array
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static void IntToFloatArray(const TArray<int32>& Source, TArray<float>& Target);
+
+	/**
+	 * Turn a Float array into an Int array
+	 * @param Source			Source array
+	 * @param RoundingMode		How each float is rounded
+	 * @param Target			Target array
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static void FloatToIntArray(const TArray<float>& Source, EAwesomeBLRoundingMode RoundingMode, TArray<int32>& Target);
+
+	//~~~~~~~~~~~~~~~~~~~~~~~~~
+	//~~~~~   Reductions   ~~~~
+	//~~~~~~~~~~~~~~~~~~~~~~~~~
+
+	/** @return Sum of all elements, 0 for an empty array */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static float SumFloatArray(const TArray<float>& Values);
+
+	/** @return Sum of all elements, 0 for an empty array */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static int64 SumIntArray(const TArray<int32>& Values);
+
+	/** @return Component wise sum of all elements, zero for an empty array */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static FVector SumVectorArray(const TArray<FVector>& Values);
+
+	/**
+	 * Find the smallest and largest element
+	 * @param Values			Array to search
+	 * @param Min				Smallest element
+	 * @param Max				Largest element
+	 * @return					False if the array is empty
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static bool GetFloatArrayMinMax(const TArray<float>& Values, float& Min, float& Max);
+
+	/**
+	 * Find the smallest and largest element
+	 * @param Values			Array to search
+	 * @param Min				Smallest element
+	 * @param Max				Largest element
+	 * @return					False if the array is empty
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static bool GetIntArrayMinMax(const TArray<int32>& Values, int32& Min, int32& Max);
+
+	/**
+	 * Find the component wise bounds of the elements
+	 * @param Values			Array to search
+	 * @param Min				Smallest X, Y and Z
+	 * @param Max				Largest X, Y and Z
+	 * @return					False if the array is empty
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static bool GetVectorArrayBounds(const TArray<FVector>& Values, FVector& Min, FVector& Max);
+
+	//~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	//~~~~~   Element wise   ~~~~
+	//~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+	/**
+	 * Multiply every element
+	 * @param Source			Source array
+	 * @param Scale				Multiplier
+	 * @param Target			Target array
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static void ScaleFloatArray(const TArray<float>& Source, float Scale, TArray<float>& Target);
+
+	/**
+	 * Multiply every element in place
+	 * @param Values			Array to modify
+	 * @param Scale				Multiplier
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Array Math")
+	static void ScaleFloatArrayInPlace(UPARAM(ref) TArray<float>& Values, float Scale);
+
+	/**
+	 * Multiply every element
+	 * @param Source			Source array
+	 * @param Scale				Multiplier
+	 * @param Target			Target array
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static void ScaleIntArray(const TArray<int32>& Source, int32 Scale, TArray<int32>& Target);
+
+	/**
+	 * Multiply every element in place
+	 * @param Values			Array to modify
+	 * @param Scale				Multiplier
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Array Math")
+	static void ScaleIntArrayInPlace(UPARAM(ref) TArray<int32>& Values, int32 Scale);
+
+	/**
+	 * Multiply every element component wise
+	 * @param Source			Source array
+	 * @param Scale				Multiplier per component
+	 * @param Target			Target array
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static void ScaleVectorArray(const TArray<FVector>& Source, FVector Scale, TArray<FVector>& Target);
+
+	/**
+	 * Multiply every element component wise in place
+	 * @param Values			Array to modify
+	 * @param Scale				Multiplier per component
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Array Math")
+	static void ScaleVectorArrayInPlace(UPARAM(ref) TArray<FVector>& Values, FVector Scale);
+
+	/**
+	 * Clamp every element
+	 * @param Source			Source array
+	 * @param Min				Lower bound
+	 * @param Max				Upper bound
+	 * @param Target			Target array
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static void ClampFloatArray(const TArray<float>& Source, float Min, float Max, TArray<float>& Target);
+
+	/**
+	 * Clamp every element in place
+	 * @param Values			Array to modify
+	 * @param Min				Lower bound
+	 * @param Max				Upper bound
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Array Math")
+	static void ClampFloatArrayInPlace(UPARAM(ref) TArray<float>& Values, float Min, float Max);
+
+	/**
+	 * Clamp every element
+	 * @param Source			Source array
+	 * @param Min				Lower bound
+	 * @param Max				Upper bound
+	 * @param Target			Target array
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static void ClampIntArray(const TArray<int32>& Source, int32 Min, int32 Max, TArray<int32>& Target);
+
+	/**
+	 * Clamp every element in place
+	 * @param Values			Array to modify
+	 * @param Min				Lower bound
+	 * @param Max				Upper bound
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Array Math")
+	static void ClampIntArrayInPlace(UPARAM(ref) TArray<int32>& Values, int32 Min, int32 Max);
+
+	/**
+	 * Clamp every element component wise
+	 * @param Source			Source array
+	 * @param Min				Lower bound per component
+	 * @param Max				Upper bound per component
+	 * @param Target			Target array
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static void ClampVectorArray(const TArray<FVector>& Source, FVector Min, FVector Max, TArray<FVector>& Target);
+
+	/**
+	 * Clamp every element component wise in place
+	 * @param Values			Array to modify
+	 * @param Min				Lower bound per component
+	 * @param Max				Upper bound per component
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Array Math")
+	static void ClampVectorArrayInPlace(UPARAM(ref) TArray<FVector>& Values, FVector Min, FVector Max);
+
+	/**
+	 * Linearly interpolate between two arrays
+	 * @param A					Values at Alpha 0
+	 * @param B					Values at Alpha 1
+	 * @param Alpha				Interpolation factor
+	 * @param Target			Target array, as long as the shorter input
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static void LerpFloatArrays(const TArray<float>& A, const TArray<float>& B, float Alpha, TArray<float>& Target);
+
+	/**
+	 * Linearly interpolate between two arrays, writing into the first one
+	 * @param A					Values at Alpha 0, receives the result. Elements past the end of B are left as is
+	 * @param B					Values at Alpha 1
+	 * @param Alpha				Interpolation factor
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Array Math")
+	static void LerpFloatArraysInPlace(UPARAM(ref) TArray<float>& A, const TArray<float>& B, float Alpha);
+
+	/**
+	 * Linearly interpolate between two arrays
+	 * @param A					Values at Alpha 0
+	 * @param B					Values at Alpha 1
+	 * @param Alpha				Interpolation factor
+	 * @param Target			Target array, as long as the shorter input
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Array Math")
+	static void LerpVectorArrays(const TArray<FVector>& A, const TArray<FVector>& B, float Alpha, TArray<FVector>& Target);
+
+	/**
+	 * Linearly interpolate between two arrays, writing into the first one
+	 * @param A					Values at Alpha 0, receives the result. Elements past the end of B are left as is
+	 * @param B					Values at Alpha 1
+	 * @param Alpha				Interpolation factor
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Array Math")
+	static void LerpVectorArraysInPlace(UPARAM(ref) TArray<FVector>& A, const TArray<FVector>& B, float Alpha);
+};
@@ -0,0 +1,170 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/List.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "AwesomeBLAssetCache.generated.h"
+
+/** How the asset cache picks what to evict once it is over budget */
+UENUM(BlueprintType)
+enum class EAwesomeBLCacheEvictionPolicy : uint8
+{
+	/** Evict the assets that were not requested for the longest time */
+	LeastRecentlyUsed,
+	/** Evict the assets with the highest size times age among the least recently used ones, large cold assets go before small cold ones */
+	SizeWeighted,
+};
+
+/**
+ * Hit, miss and memory counters of the asset cache
+ */
+USTRUCT(BlueprintType)
+struct FAwesomeBLAssetCacheStats
+{
+	GENERATED_BODY()
+public:
+
+	/** Loads fully served from the cache */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Asset Cache")
+	int32 NumHits = 0;
+
+	/** Loads that had to go to the streamable manager */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Asset Cache")
+	int32 NumMisses = 0;
+
+	/** Assets dropped from the cache to stay under budget */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Asset Cache")
+	int32 NumEvictions = 0;
+
+	/** Assets currently in the cache */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Asset Cache")
+	int32 NumAssets = 0;
+
+	/** Assets currently pinned, these are never evicted */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Asset Cache")
+	int32 NumPinnedAssets = 0;
+
+	/** Exclusive resource size of the cached assets */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Asset Cache")
+	int64 CachedBytes = 0;
+
+	/** Memory budget of the cache */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Asset Cache")
+	int64 BudgetBytes = 0;
+};
+
+/**
+ * Keeps assets loaded through the UAwesomeBL soft object loaders resident within a memory budget, so loading a hot
+ * asset again does not need a new streamable request. Assets over budget are evicted by
+ * AwesomeBL.AssetCache.EvictionPolicy unless pinned. Enable with AwesomeBL.AssetCache.Enabled.
+ * @note Primary asset loads are not cached, the asset manager already keeps those resident until they are unloaded.
+ */
+UCLASS()
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLAssetCache : public UEngineSubsystem
+{
+	GENERATED_BODY()
+public:
+
+	/** @return The cache if it exists and is enabled, null otherwise */
+	static UAwesomeBLAssetCache* GetIfEnabled();
+
+	/**
+	 * Check whether every path is cached, counting a hit or a miss and marking the assets as used on a hit.
+	 * @param Paths				Paths about to be loaded.
+	 * @return					Whether all of them are cached and still loaded, false without counting anything if there are none.
+	 */
+	bool TryUseAssets(TConstArrayView<FSoftObjectPath> Paths);
+
+	/**
+	 * Call a load delegate on the next tick, the same way the streamable manager completes loads that had nothing to load.
+	 * @param OnLoad			Delegate of the load served from the cache.
+	 */
+	static void ExecuteNextTick(FStreamableDelegate&& OnLoad);
+
+	/**
+	 * Add a loaded asset to the cache, or mark it as used if already cached. May evict other assets.
+	 * @param Path				Path the asset was loaded from.
+	 * @param Asset				Loaded asset.
+	 */
+	void AddAsset(const FSoftObjectPath& Path, UObject* Asset);
+
+	/**
+	 * Keep an asset in the cache regardless of the budget. Loaded assets that are not cached yet are added.
+	 * @param Asset				Asset to pin.
+	 * @return					Whether the asset is loaded and now pinned.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Asset Cache")
+	bool PinAsset(TSoftObjectPtr<UObject> Asset);
+
+	/**
+	 * Let a pinned asset be evicted again.
+	 * @param Asset				Asset to unpin.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Asset Cache")
+	void UnpinAsset(TSoftObjectPtr<UObject> Asset);
+
+	/** @return Whether the asset is currently held by the cache */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Asset Cache")
+	bool IsAssetCached(TSoftObjectPtr<UObject> Asset) const;
+
+	/**
+	 * Drop every cached asset.
+	 * @param bKeepPinned		Keep the pinned assets.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Asset Cache")
+	void ClearCache(bool bKeepPinned = true);
+
+	/** @return Current cache counters */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Asset Cache")
+	FAwesomeBLAssetCacheStats GetStats() const;
+
+	/** Reset the hit, miss and eviction counters */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Asset Cache")
+	void ResetStats();
+
+	//~ Begin UObject Interface
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+	//~ End UObject Interface
+
+	//~ Begin USubsystem Interface
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+private:
+
+	using FUseOrder = TDoubleLinkedList<FSoftObjectPath>;
+
+	struct FCachedAsset
+	{
+		TObjectPtr<UObject> Asset;
+		int64 Bytes = 0;
+		uint64 LastUsedFrame = 0;
+		bool bPinned = false;
+
+		/** Node of the entry in UseOrder */
+		FUseOrder::TDoubleLinkedListNode* UseNode = nullptr;
+	};
+
+	/** Mark an entry as used this frame and move it to the front of the use order */
+	void Touch(FCachedAsset& CachedAsset);
+
+	/** Drop an entry and its bytes */
+	void RemoveEntry(const FSoftObjectPath& Path);
+
+	/** Evict unpinned assets, least recently used first, until the cache is back under its budget */
+	void EvictOverBudget();
+
+	TMap<FSoftObjectPath, FCachedAsset> CachedAssets;
+
+	/** Paths of the cached assets, most recently used first, so eviction starts from the tail without sorting */
+	FUseOrder UseOrder;
+
+	int64 CachedBytes = 0;
+
+	int32 NumHits = 0;
+	int32 NumMisses = 0;
+	int32 NumEvictions = 0;
+};
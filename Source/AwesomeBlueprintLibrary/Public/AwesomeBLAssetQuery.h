@@ -0,0 +1,148 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "GameplayTagContainer.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "UObject/PrimaryAssetId.h"
+#include "AwesomeBLAssetQuery.generated.h"
+
+/**
+ * Filter over the primary assets known to the asset manager, every set field has to match
+ */
+USTRUCT(BlueprintType)
+struct FAwesomeBLAssetQuery
+{
+	GENERATED_BODY()
+public:
+
+	/** Primary asset types to accept, any type when empty */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Awesome Blueprint Library|Asset Query")
+	TArray<FPrimaryAssetType> Types;
+
+	/** Gameplay tags the asset needs all of, child tags match their parents */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Awesome Blueprint Library|Asset Query")
+	FGameplayTagContainer RequiredTags;
+
+	/** Asset registry tag values the asset needs all of, compared without case */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Awesome Blueprint Library|Asset Query")
+	TMap<FName, FString> RequiredRegistryTags;
+};
+
+/**
+ * Matches of one query of a batch
+ */
+USTRUCT(BlueprintType)
+struct FAwesomeBLAssetQueryResult
+{
+	GENERATED_BODY()
+public:
+
+	/** Matching primary assets, in index order */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Asset Query")
+	TArray<FPrimaryAssetId> PrimaryAssetIds;
+};
+
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnAwesomeBLAssetQueryComplete, const TArray<FPrimaryAssetId>&, PrimaryAssetIds);
+
+/**
+ * Index of the primary assets by type, gameplay tag and asset registry tag value, built once the asset manager has
+ * finished its initial scan, or right away from the primary asset snapshot if one is mapped. Assets added, removed or
+ * renamed in the asset registry afterwards are picked up by a rebuild once the registry has been quiet for a moment.
+ * Queries intersect the matching lists starting from the shortest one, so they cost the size of the smallest list
+ * rather than the number of assets.
+ * Gameplay tags come from registry tags holding an exported FGameplayTagContainer, e.g. an AssetRegistrySearchable
+ * tag container property. Registry tag values longer than 128 characters are not indexed.
+ */
+UCLASS()
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLAssetQuerySubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+public:
+
+	using FOnQueryComplete = TFunction<void(TArray<FPrimaryAssetId>&& PrimaryAssetIds)>;
+
+	/** @return The subsystem, null before the engine is up */
+	static UAwesomeBLAssetQuerySubsystem* Get();
+
+	/** @return Whether the index has been built, queries before that return nothing */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Asset Query")
+	bool IsIndexReady() const { return Index.IsValid(); }
+
+	/** Rebuild the index from the asset manager, or from the snapshot until its scan has finished */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Asset Query")
+	void RebuildIndex();
+
+	/**
+	 * Find the primary assets matching a query.
+	 * @param Query				Filter to match.
+	 * @return					Matching primary assets.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Asset Query")
+	TArray<FPrimaryAssetId> RunQuery(const FAwesomeBLAssetQuery& Query) const;
+
+	/**
+	 * Run several queries against the same index.
+	 * @param Queries			Filters to match.
+	 * @return					One result per query, in order.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Asset Query")
+	TArray<FAwesomeBLAssetQueryResult> RunQueries(const TArray<FAwesomeBLAssetQuery>& Queries) const;
+
+	/**
+	 * Run a query on a background thread. Waits for the index if it is not built yet.
+	 * @param Query				Filter to match.
+	 * @param OnComplete		Called on the game thread with the matching primary assets.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Asset Query")
+	void RunQueryAsync(const FAwesomeBLAssetQuery& Query, const FOnAwesomeBLAssetQueryComplete& OnComplete);
+
+	/** Native version of RunQueryAsync */
+	void RunQueryAsync(const FAwesomeBLAssetQuery& Query, FOnQueryComplete&& OnComplete);
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+private:
+
+	/** Immutable once built, background queries keep the one they started with alive */
+	struct FIndex
+	{
+		/** Every indexed asset, posting lists hold indices into this */
+		TArray<FPrimaryAssetId> PrimaryAssetIds;
+
+		/** Sorted posting lists */
+		TMap<FPrimaryAssetType, TArray<int32>> ByType;
+		TMap<FGameplayTag, TArray<int32>> ByGameplayTag;
+		/** Values are kept as strings, making names of them would grow the name table by every description and guid */
+		TMap<TPair<FName, FString>, TArray<int32>> ByRegistryTag;
+
+		void Add(const FPrimaryAssetId& PrimaryAssetId, const FAssetData& AssetData);
+		TArray<FPrimaryAssetId> Run(const FAwesomeBLAssetQuery& Query) const;
+	};
+
+	struct FPendingQuery
+	{
+		FAwesomeBLAssetQuery Query;
+		FOnQueryComplete OnComplete;
+	};
+
+	static TSharedRef<const FIndex> BuildIndexFromAssetManager();
+	static TSharedRef<const FIndex> BuildIndexFromSnapshot();
+
+	static void LaunchQuery(const TSharedRef<const FIndex>& QueryIndex, FAwesomeBLAssetQuery&& Query, FOnQueryComplete&& OnComplete);
+
+	/** Push the pending rebuild back, so a burst of registry changes rebuilds once */
+	void OnAssetRegistryChanged();
+
+	TSharedPtr<const FIndex> Index;
+
+	/** Async queries made before the index was built */
+	TArray<FPendingQuery> PendingQueries;
+
+	FTSTicker::FDelegateHandle RebuildTickerHandle;
+};
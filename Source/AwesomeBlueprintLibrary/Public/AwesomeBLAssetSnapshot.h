@@ -0,0 +1,164 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "UObject/PrimaryAssetId.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Memory mapped snapshot of the primary assets known to the asset manager, written ahead of time by the
+ * AwesomeBLPrimaryAssetIndex commandlet. It answers primary asset lookups from the moment the module loads, long
+ * before the asset manager has finished its initial scan. Once the scan has finished the live registry is used
+ * instead and the snapshot is unmapped.
+ * A snapshot written by another format version or build is ignored. So is one that refers to assets the live asset
+ * registry doesn't have, checked as soon as the registry has finished loading, which in cooked builds is before the
+ * first lookup. Primary assets added since the snapshot was written are only found once the scan has finished.
+ * Packaged builds need the snapshot directory staged as a loose file, e.g.
+ * +DirectoriesToAlwaysStageAsNonUFS=(Path="AwesomeBL"), since pak files can't be mapped.
+ * Game thread only.
+ */
+class AWESOMEBLUEPRINTLIBRARY_API FAwesomeBLAssetSnapshot
+{
+public:
+
+	static FAwesomeBLAssetSnapshot& Get();
+
+	/** @return Where the snapshot is written to and read from */
+	static FString GetDefaultFilename();
+
+	/**
+	 * Map a snapshot file, dropping any snapshot mapped before.
+	 * @param Filename			File to map.
+	 * @return					Whether the file is a valid snapshot of this build.
+	 */
+	bool Open(const FString& Filename);
+
+	/** Unmap the snapshot */
+	void Close();
+
+	/** @return Whether a snapshot is mapped */
+	bool IsOpen() const { return Header != nullptr; }
+
+	/**
+	 * Check the snapshot against the live asset registry once the registry has finished loading, closing it if any
+	 * of its assets no longer exists. Lookups do this on their own.
+	 * @return					Whether the snapshot is still open.
+	 */
+	bool Validate();
+
+	/** @return Number of primary assets in the snapshot */
+	int32 Num() const;
+
+	/**
+	 * Find the asset data of a primary asset, see UAssetManager::GetPrimaryAssetData.
+	 * @param PrimaryAssetId	Primary Asset Id to get the Asset Data from.
+	 * @param OutAssetData		Asset data with its registry tags, left untouched if not found.
+	 * @return					Whether the snapshot has the primary asset.
+	 */
+	bool GetPrimaryAssetData(const FPrimaryAssetId& PrimaryAssetId, FAssetData& OutAssetData);
+
+	/**
+	 * Call a function for every primary asset, in snapshot order.
+	 * @param Function			Called with the id and asset data of each primary asset.
+	 */
+	void ForEachPrimaryAsset(TFunctionRef<void(const FPrimaryAssetId&, const FAssetData&)> Function);
+
+	/**
+	 * Hash of the snapshotted ids, types and names. Compare with ComputeContentHash of the live registry to
+	 * find out whether the snapshot was stale.
+	 */
+	uint32 GetContentHash() const;
+
+	/**
+	 * Hash the ids the way the snapshot does.
+	 * @param PrimaryAssetIds	Ids to hash, in any order.
+	 * @return					Order independent hash.
+	 */
+	static uint32 ComputeContentHash(TConstArrayView<FPrimaryAssetId> PrimaryAssetIds);
+
+#if WITH_EDITOR
+	/**
+	 * Write a snapshot of the primary assets the asset manager has scanned.
+	 * @param Filename			File to write.
+	 * @return					Whether the file was written.
+	 */
+	static bool Write(const FString& Filename);
+#endif
+
+private:
+
+	FAwesomeBLAssetSnapshot() = default;
+	~FAwesomeBLAssetSnapshot();
+
+	static constexpr uint32 Magic = 0x4C424157; // 'AWBL'
+	static constexpr uint32 FormatVersion = 1;
+
+	/** UTF-8 string in the string blob, not null terminated */
+	struct FStringRef
+	{
+		uint32 Offset;
+		uint32 Len;
+	};
+
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 FormatVersion;
+		uint32 BuildHash;
+		uint32 ContentHash;
+		uint32 NumEntries;
+		uint32 NumTags;
+		uint32 StringsSize;
+		uint32 Padding;
+	};
+
+	/** Entries are sorted by Key without case */
+	struct FEntry
+	{
+		/** PrimaryAssetType:PrimaryAssetName */
+		FStringRef Key;
+		FStringRef PackageName;
+		FStringRef AssetName;
+		FStringRef ClassPath;
+		uint32 FirstTag;
+		uint32 NumTags;
+	};
+
+	struct FTag
+	{
+		FStringRef Key;
+		FStringRef Value;
+	};
+
+	/** Hash of what makes a snapshot belong to a build */
+	static uint32 ComputeBuildHash();
+
+	/** @return Whether every string, tag range and key of the mapped data lies within it */
+	bool AreOffsetsValid() const;
+
+	FUtf8StringView GetString(const FStringRef& Ref) const;
+	FPrimaryAssetId MakePrimaryAssetId(const FEntry& Entry) const;
+	FAssetData MakeAssetData(const FEntry& Entry) const;
+
+	/** Unmap once the live registry can answer */
+	void RegisterInitialScanCallback();
+	void OnCompletedInitialScan();
+
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** Views into the mapped region */
+	const FHeader* Header = nullptr;
+	TConstArrayView<FEntry> Entries;
+	TConstArrayView<FTag> Tags;
+	const UTF8CHAR* Strings = nullptr;
+
+	/** Set once the snapshot has been checked against the loaded asset registry */
+	bool bValidated = false;
+
+	FDelegateHandle PostEngineInitHandle;
+};
@@ -0,0 +1,238 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AwesomeBLLoadCoalescer.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "UObject/PrimaryAssetId.h"
+#include "AwesomeBLAsyncLoadActions.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FAwesomeBLAsyncLoadAssetPin, UObject*, Asset);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FAwesomeBLAsyncLoadAssetsPin, const TArray<UObject*>&, Assets);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FAwesomeBLAsyncLoadClassPin, UClass*, Class);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FAwesomeBLAsyncLoadPrimaryAssetPin, const FPrimaryAssetId&, PrimaryAssetId, UObject*, Asset);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FAwesomeBLAsyncLoadPrimaryAssetsPin, const TArray<FPrimaryAssetId>&, PrimaryAssetIds, const TArray<UObject*>&, Assets);
+
+/**
+ * Base of the latent load nodes. Loads go straight through the UAwesomeBL templates and report back through the
+ * node's output pins, so there is no delegate to bind by name. The node keeps the loaded assets resident until it
+ * finishes, whatever runs off the output pins has to keep its own reference.
+ */
+UCLASS(Abstract)
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLAsyncLoadActionBase : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+public:
+
+	/** Stop the load, no output pin fires */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Loading Helpers")
+	void Cancel();
+
+protected:
+
+	/** Let the node be destroyed and drop the load handle */
+	void Finish();
+
+	TSharedPtr<FStreamableHandle> Handle;
+
+	/** Identifies the node's load within a merged load, for Cancel */
+	FAwesomeBLLoadToken Token;
+
+	/** Set once an output pin fired or the node was canceled, later callbacks are ignored */
+	bool bFinished = false;
+};
+
+/**
+ * Latent node loading a soft object reference
+ */
+UCLASS()
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLAsyncLoadAsset : public UAwesomeBLAsyncLoadActionBase
+{
+	GENERATED_BODY()
+public:
+
+	/**
+	 * Async load a SoftObjectPtr.
+	 * @param WorldContextObject	Object that we can obtain a world context from
+	 * @param AssetToLoad			SoftObjectPtr to be loaded.
+	 * @param Priority				Priority of the load, higher loads first.
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Async Load Asset (Latent)", Category="Awesome Blueprint Library|Loading Helpers", meta=(WorldContext="WorldContextObject", BlueprintInternalUseOnly="true"))
+	static UAwesomeBLAsyncLoadAsset* AsyncLoadAssetLatent(UObject* WorldContextObject, TSoftObjectPtr<UObject> AssetToLoad, int32 Priority = 0);
+
+	/** Called with the loaded asset */
+	UPROPERTY(BlueprintAssignable)
+	FAwesomeBLAsyncLoadAssetPin OnLoaded;
+
+	/** Called when the asset could not be loaded */
+	UPROPERTY(BlueprintAssignable)
+	FAwesomeBLAsyncLoadAssetPin OnFailed;
+
+	//~ Begin UBlueprintAsyncActionBase Interface
+	virtual void Activate() override;
+	//~ End UBlueprintAsyncActionBase Interface
+
+private:
+
+	void HandleLoaded(UObject* LoadedAsset);
+
+	TSoftObjectPtr<UObject> AssetToLoad;
+	int32 Priority = 0;
+};
+
+/**
+ * Latent node loading a list of soft object references
+ */
+UCLASS()
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLAsyncLoadAssets : public UAwesomeBLAsyncLoadActionBase
+{
+	GENERATED_BODY()
+public:
+
+	/**
+	 * Async load a list of SoftObjectPtrs.
+	 * @param WorldContextObject	Object that we can obtain a world context from
+	 * @param AssetListToLoad		SoftObjectPtr list to be loaded.
+	 * @param Priority				Priority of the load, higher loads first.
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Async Load Assets (Latent)", Category="Awesome Blueprint Library|Loading Helpers", meta=(WorldContext="WorldContextObject", BlueprintInternalUseOnly="true"))
+	static UAwesomeBLAsyncLoadAssets* AsyncLoadAssetsLatent(UObject* WorldContextObject, const TArray<TSoftObjectPtr<UObject>>& AssetListToLoad, int32 Priority = 0);
+
+	/** Called with the loaded assets, in request order */
+	UPROPERTY(BlueprintAssignable)
+	FAwesomeBLAsyncLoadAssetsPin OnLoaded;
+
+	/** Called with the assets that did load when any of them could not be loaded */
+	UPROPERTY(BlueprintAssignable)
+	FAwesomeBLAsyncLoadAssetsPin OnFailed;
+
+	//~ Begin UBlueprintAsyncActionBase Interface
+	virtual void Activate() override;
+	//~ End UBlueprintAsyncActionBase Interface
+
+private:
+
+	void HandleLoaded(const TArray<UObject*>& LoadedAssets);
+
+	TArray<TSoftObjectPtr<UObject>> AssetListToLoad;
+	int32 Priority = 0;
+};
+
+/**
+ * Latent node loading a soft class reference
+ */
+UCLASS()
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLAsyncLoadClass : public UAwesomeBLAsyncLoadActionBase
+{
+	GENERATED_BODY()
+public:
+
+	/**
+	 * Async load a SoftClassPtr.
+	 * @param WorldContextObject	Object that we can obtain a world context from
+	 * @param ClassToLoad			SoftClassPtr to be loaded.
+	 * @param Priority				Priority of the load, higher loads first.
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Async Load Class (Latent)", Category="Awesome Blueprint Library|Loading Helpers", meta=(WorldContext="WorldContextObject", BlueprintInternalUseOnly="true"))
+	static UAwesomeBLAsyncLoadClass* AsyncLoadClassLatent(UObject* WorldContextObject, TSoftClassPtr<UObject> ClassToLoad, int32 Priority = 0);
+
+	/** Called with the loaded class */
+	UPROPERTY(BlueprintAssignable)
+	FAwesomeBLAsyncLoadClassPin OnLoaded;
+
+	/** Called when the class could not be loaded */
+	UPROPERTY(BlueprintAssignable)
+	FAwesomeBLAsyncLoadClassPin OnFailed;
+
+	//~ Begin UBlueprintAsyncActionBase Interface
+	virtual void Activate() override;
+	//~ End UBlueprintAsyncActionBase Interface
+
+private:
+
+	void HandleLoaded(UClass* LoadedClass);
+
+	TSoftClassPtr<UObject> ClassToLoad;
+	int32 Priority = 0;
+};
+
+/**
+ * Latent node loading a primary asset
+ */
+UCLASS()
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLAsyncLoadPrimaryAsset : public UAwesomeBLAsyncLoadActionBase
+{
+	GENERATED_BODY()
+public:
+
+	/**
+	 * Loads a PrimaryAsset.
+	 * @param WorldContextObject	Object that we can obtain a world context from
+	 * @param AssetToLoad			PrimaryAsset to be loaded.
+	 * @param LoadBundles			Bundles to activate with load.
+	 * @param Priority				Priority of the load, higher loads first.
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Async Load Primary Asset (Latent)", Category="Awesome Blueprint Library|Loading Helpers", meta=(WorldContext="WorldContextObject", BlueprintInternalUseOnly="true", AutoCreateRefTerm="LoadBundles"))
+	static UAwesomeBLAsyncLoadPrimaryAsset* AsyncLoadPrimaryAssetLatent(UObject* WorldContextObject, const FPrimaryAssetId& AssetToLoad, const TArray<FName>& LoadBundles, int32 Priority = 0);
+
+	/** Called with the loaded primary asset */
+	UPROPERTY(BlueprintAssignable)
+	FAwesomeBLAsyncLoadPrimaryAssetPin OnLoaded;
+
+	/** Called when the primary asset could not be loaded */
+	UPROPERTY(BlueprintAssignable)
+	FAwesomeBLAsyncLoadPrimaryAssetPin OnFailed;
+
+	//~ Begin UBlueprintAsyncActionBase Interface
+	virtual void Activate() override;
+	//~ End UBlueprintAsyncActionBase Interface
+
+private:
+
+	void HandleLoaded(const FPrimaryAssetId& LoadedId, UObject* LoadedAsset);
+
+	FPrimaryAssetId AssetToLoad;
+	TArray<FName> LoadBundles;
+	int32 Priority = 0;
+};
+
+/**
+ * Latent node loading a list of primary assets
+ */
+UCLASS()
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLAsyncLoadPrimaryAssets : public UAwesomeBLAsyncLoadActionBase
+{
+	GENERATED_BODY()
+public:
+
+	/**
+	 * Loads a list of PrimaryAssets.
+	 * @param WorldContextObject	Object that we can obtain a world context from
+	 * @param AssetsToLoad			PrimaryAssets to be loaded.
+	 * @param LoadBundles			Bundles to activate with load.
+	 * @param Priority				Priority of the load, higher loads first.
+	 */
+	UFUNCTION(BlueprintCallable, DisplayName="Async Load Primary Assets (Latent)", Category="Awesome Blueprint Library|Loading Helpers", meta=(WorldContext="WorldContextObject", BlueprintInternalUseOnly="true", AutoCreateRefTerm="LoadBundles"))
+	static UAwesomeBLAsyncLoadPrimaryAssets* AsyncLoadPrimaryAssetsLatent(UObject* WorldContextObject, const TArray<FPrimaryAssetId>& AssetsToLoad, const TArray<FName>& LoadBundles, int32 Priority = 0);
+
+	/** Called with the loaded primary assets */
+	UPROPERTY(BlueprintAssignable)
+	FAwesomeBLAsyncLoadPrimaryAssetsPin OnLoaded;
+
+	/** Called with the primary assets that did load when any of them could not be loaded */
+	UPROPERTY(BlueprintAssignable)
+	FAwesomeBLAsyncLoadPrimaryAssetsPin OnFailed;
+
+	//~ Begin UBlueprintAsyncActionBase Interface
+	virtual void Activate() override;
+	//~ End UBlueprintAsyncActionBase Interface
+
+private:
+
+	void HandleLoaded(const TArray<FPrimaryAssetId>& LoadedIds, const TArray<UObject*>& LoadedAssets);
+
+	TArray<FPrimaryAssetId> AssetsToLoad;
+	TArray<FName> LoadBundles;
+	int32 Priority = 0;
+};
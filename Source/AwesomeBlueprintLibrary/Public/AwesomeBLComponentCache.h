@@ -0,0 +1,89 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "UObject/FieldPath.h"
+#include "UObject/ObjectKey.h"
+
+/**
+ * Remembers what component references resolved to, so resolving the same reference against the same actor again
+ * skips the property or path search. Path results are dropped once the component dies, changes owner or the actor
+ * gains or loses components. Property references only cache the property lookup, their value is read on every call.
+ * Entries of destroyed actors are purged after garbage collection, property lookups are dropped when objects are
+ * reinstanced in the editor. Game thread only, other threads resolve directly.
+ */
+class AWESOMEBLUEPRINTLIBRARY_API FAwesomeBLComponentCache
+{
+public:
+
+	static FAwesomeBLComponentCache& Get();
+
+	/**
+	 * Resolve a component reference, see FComponentReference::GetComponent.
+	 * @param Reference			Reference to resolve.
+	 * @param OwningActor		Actor to search on. Ignored if OtherActor is set.
+	 * @return					Found ActorComponent.
+	 */
+	UActorComponent* GetComponent(const FComponentReference& Reference, AActor* OwningActor);
+
+	/**
+	 * Resolve a soft component reference, see FSoftComponentReference::GetComponent.
+	 * @param Reference			Reference to resolve.
+	 * @param OwningActor		Actor to search on. Ignored if OtherActor is set.
+	 * @return					Found ActorComponent.
+	 */
+	UActorComponent* GetComponent(const FSoftComponentReference& Reference, AActor* OwningActor);
+
+	/** @return Number of lookups served from the cache */
+	int32 GetNumHits() const { return NumHits; }
+
+	/** @return Number of lookups that had to search */
+	int32 GetNumMisses() const { return NumMisses; }
+
+	/** Reset hit and miss counters */
+	void ResetStats();
+
+	/** Drop every cached entry */
+	void Empty();
+
+private:
+
+	FAwesomeBLComponentCache() = default;
+
+	struct FPathEntry
+	{
+		FString PathToComponent;
+		TWeakObjectPtr<UActorComponent> Component;
+		int32 NumComponents = 0;
+	};
+
+	template<typename ReferenceType>
+	UActorComponent* Resolve(const ReferenceType& Reference, AActor* OwningActor);
+
+	FObjectPropertyBase* FindComponentProperty(UClass* Class, FName ComponentProperty);
+	UActorComponent* FindComponentByPath(AActor* SearchActor, const FString& PathToComponent);
+
+	/** Register the garbage collection purge and the reinstancing reset on first use */
+	void EnsurePurgeRegistered();
+	void PurgeStaleEntries();
+
+	/** Keyed by actor and path hash, the stored path catches hash collisions */
+	TMap<TPair<TObjectKey<AActor>, uint32>, FPathEntry> PathEntries;
+
+	/**
+	 * Component properties by class and name, empty when the class has no such property. Field paths notice when a
+	 * recompile frees the property they point to, a raw pointer would dangle.
+	 */
+	TMap<TPair<TObjectKey<UClass>, FName>, TFieldPath<FObjectPropertyBase>> ComponentProperties;
+
+	FDelegateHandle PostGarbageCollectHandle;
+
+#if WITH_EDITOR
+	FDelegateHandle ObjectsReplacedHandle;
+#endif
+
+	int32 NumHits = 0;
+	int32 NumMisses = 0;
+};
@@ -0,0 +1,41 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AwesomeBLTypes.h"
+#include "Engine/StreamableManager.h"
+#include "UObject/PrimaryAssetId.h"
+
+/**
+ * List loads that hand out every asset as soon as it has loaded instead of waiting for the slowest one.
+ * Used by the UAwesomeBL streaming templates, game thread only.
+ */
+class AWESOMEBLUEPRINTLIBRARY_API FAwesomeBLIncrementalLoad
+{
+public:
+
+	/** Called once per loaded asset with its index in the requested list */
+	using FOnAssetLoaded = TFunction<void(int32 Index, UObject* LoadedAsset, const FAwesomeBLLoadProgress& Progress)>;
+
+	/**
+	 * Async load a list of soft object paths, reporting each asset as it finishes.
+	 * @param Paths				Paths to load, null paths are skipped but keep their index.
+	 * @param OnAssetLoaded		Called for each asset as it finishes loading.
+	 * @param OnComplete		Called once every asset has been reported.
+	 * @param Priority			Priority of the load, higher loads first.
+	 * @return					Handle to the request, the assets stay resident for as long as it is alive.
+	 */
+	static TSharedPtr<FStreamableHandle> RequestAsyncLoad(TArray<FSoftObjectPath> Paths, FOnAssetLoaded OnAssetLoaded, FStreamableDelegate OnComplete, TAsyncLoadPriority Priority);
+
+	/**
+	 * Load a list of primary assets, reporting each asset once it and its requested bundles have finished.
+	 * @param PrimaryAssetIds	PrimaryAssets to load, invalid ids are skipped but keep their index.
+	 * @param LoadBundles		Bundles to activate with load.
+	 * @param OnAssetLoaded		Called for each asset as it finishes loading.
+	 * @param OnComplete		Called once every asset has been reported.
+	 * @param Priority			Priority of the load, higher loads first.
+	 * @return					Handle to the request, null if the asset manager is not initialized.
+	 */
+	static TSharedPtr<FStreamableHandle> LoadPrimaryAssets(const TArray<FPrimaryAssetId>& PrimaryAssetIds, const TArray<FName>& LoadBundles, FOnAssetLoaded OnAssetLoaded, FStreamableDelegate OnComplete, TAsyncLoadPriority Priority);
+};
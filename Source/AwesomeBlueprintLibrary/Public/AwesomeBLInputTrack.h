@@ -0,0 +1,147 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "InputCoreTypes.h"
+#include "AwesomeBLInputTrack.generated.h"
+
+class IInputProcessor;
+
+UENUM(BlueprintType)
+enum class EAwesomeBLInputEventType : uint8
+{
+	Analog,
+	Pressed,
+	Released
+};
+
+/**
+ * One input event of a track
+ */
+USTRUCT(BlueprintType)
+struct AWESOMEBLUEPRINTLIBRARY_API FAwesomeBLInputEvent
+{
+	GENERATED_BODY()
+public:
+
+	/** Frames since the start of the track */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Awesome Blueprint Library|Input")
+	int32 Frame = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Awesome Blueprint Library|Input")
+	EAwesomeBLInputEventType Type = EAwesomeBLInputEventType::Pressed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Awesome Blueprint Library|Input")
+	FKey Key;
+
+	/** Only used by analog events */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Awesome Blueprint Library|Input")
+	float AnalogValue = 0.f;
+
+	/** Slate user index of the controller */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Awesome Blueprint Library|Input")
+	int32 ControllerId = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Awesome Blueprint Library|Input")
+	bool bRepeat = false;
+
+	/** Look up the key and char codes of Key, needed before Inject */
+	void PrepareCodes();
+
+	/** Send the event to Slate as if it came from the controller */
+	void Inject() const;
+
+private:
+
+	uint32 KeyCode = 0;
+	uint32 CharCode = 0;
+	bool bHasCharCode = false;
+};
+
+/**
+ * Frame timestamped input events of any number of controllers, recorded with FAwesomeBLInputTrackPlayer or written
+ * by hand, and saved as JSON.
+ */
+USTRUCT(BlueprintType)
+struct AWESOMEBLUEPRINTLIBRARY_API FAwesomeBLInputTrack
+{
+	GENERATED_BODY()
+public:
+
+	/** Sorted by frame once prepared, events of the same frame keep their order */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Awesome Blueprint Library|Input")
+	TArray<FAwesomeBLInputEvent> Events;
+
+	/** Sort the events and look up their codes, so playing them does no lookups */
+	void Prepare();
+
+	/** @return Frame of the last event plus one */
+	int32 GetNumFrames() const { return Events.Num() > 0 ? Events.Last().Frame + 1 : 0; }
+
+	/**
+	 * Write the track as JSON.
+	 * @param Filename			File to write.
+	 * @return					Whether the file was written.
+	 */
+	bool SaveToFile(const FString& Filename) const;
+
+	/**
+	 * Read a track written by SaveToFile and prepare it.
+	 * @param Filename			File to read.
+	 * @return					Whether the file was read.
+	 */
+	bool LoadFromFile(const FString& Filename);
+};
+
+/**
+ * Records the key and analog input Slate receives into a track, and plays tracks back. Playback is timed in frames
+ * rather than seconds, and every event due in a frame is injected at once from the core ticker, so a track drives
+ * the same frames whatever the frame rate. Pair with a fixed frame rate (-benchmark -fps=N) to also get the same
+ * game time for performance captures.
+ * Game thread only.
+ */
+class AWESOMEBLUEPRINTLIBRARY_API FAwesomeBLInputTrackPlayer
+{
+public:
+
+	static FAwesomeBLInputTrackPlayer& Get();
+
+	/** Start recording, dropping any recording in progress */
+	void StartRecording();
+
+	/** @return The events recorded since StartRecording, prepared */
+	FAwesomeBLInputTrack StopRecording();
+
+	/** @return Whether input is being recorded */
+	bool IsRecording() const { return Recorder.IsValid(); }
+
+	/**
+	 * Play a track from its first frame, stopping any track playing. Input injected by the track isn't recorded.
+	 * @param Track				Track to play, prepared if it isn't already.
+	 */
+	void Play(FAwesomeBLInputTrack Track);
+
+	/** Stop playing, events not injected yet are dropped */
+	void Stop();
+
+	/** @return Whether a track is playing */
+	bool IsPlaying() const { return TickerHandle.IsValid(); }
+
+	/** Broadcast when a track has injected its last event */
+	FSimpleMulticastDelegate OnFinished;
+
+private:
+
+	FAwesomeBLInputTrackPlayer() = default;
+
+	bool Tick(float DeltaTime);
+
+	TSharedPtr<IInputProcessor> Recorder;
+
+	FAwesomeBLInputTrack PlayingTrack;
+	int32 NextEvent = 0;
+	uint64 StartFrame = 0;
+	FTSTicker::FDelegateHandle TickerHandle;
+};
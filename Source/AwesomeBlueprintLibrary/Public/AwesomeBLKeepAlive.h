@@ -0,0 +1,118 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "AwesomeBLKeepAlive.generated.h"
+
+/**
+ * Size of a keep-alive group
+ */
+USTRUCT(BlueprintType)
+struct FAwesomeBLKeepAliveGroupStats
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|GameInstance Helpers")
+	FName Group;
+
+	/** Objects registered in the group */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|GameInstance Helpers")
+	int32 NumObjects = 0;
+
+	/** Exclusive resource size of the objects, sampled when they were registered if AwesomeBL.KeepAlive.TrackMemory is set */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|GameInstance Helpers")
+	int64 ResourceBytes = 0;
+};
+
+/**
+ * Keeps objects alive for as long as the game instance, in named groups that can be released in one call. Objects
+ * live in hashed sets, so registering and unregistering cost the same with ten or ten thousand objects, unlike
+ * UGameInstance::RegisterReferencedObject. The default group is None.
+ */
+UCLASS()
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLKeepAlive : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+public:
+
+	/** @return The subsystem of the game instance of the world context, null if there is none */
+	static UAwesomeBLKeepAlive* Get(const UObject* WorldContextObject);
+
+	/**
+	 * Keep an object alive as long as the game instance, or until it is unregistered or its group released.
+	 * @param Object			Object to register
+	 * @param Group				Group to register the object in, an object may be in several groups
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|GameInstance Helpers")
+	void Register(UObject* Object, FName Group = NAME_None);
+
+	/**
+	 * Let go of an object registered in a group.
+	 * @param Object			Object to unregister
+	 * @param Group				Group the object was registered in
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|GameInstance Helpers")
+	void Unregister(UObject* Object, FName Group = NAME_None);
+
+	/**
+	 * Let go of every object of a group.
+	 * @param Group				Group to release
+	 * @return					Number of objects the group held
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|GameInstance Helpers")
+	int32 ReleaseGroup(FName Group);
+
+	/** @return Whether the object is registered in the group */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|GameInstance Helpers")
+	bool IsRegistered(const UObject* Object, FName Group = NAME_None) const;
+
+	/** @return Size of every group */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|GameInstance Helpers")
+	TArray<FAwesomeBLKeepAliveGroupStats> GetGroupStats() const;
+
+	/** @return Number of objects held, counting objects in several groups once per group */
+	int32 GetNumObjects() const { return NumObjects; }
+
+	/** Log every group */
+	void Dump(FOutputDevice& Ar) const;
+
+	//~ Begin UObject Interface
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+	//~ End UObject Interface
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+private:
+
+	/** Drop the entries of objects the garbage collector cleared, e.g. objects explicitly marked as garbage */
+	void OnPostGarbageCollect();
+
+	struct FEntry
+	{
+		/** Cleared by the garbage collector if the object is destroyed while registered */
+		TObjectPtr<UObject> Object;
+
+		/** Resource size the object had when registered */
+		int64 ResourceBytes = 0;
+	};
+
+	struct FGroup
+	{
+		/** Keyed on the object key so clearing an entry's object does not change its hash */
+		TMap<TObjectKey<UObject>, FEntry> Objects;
+		int64 ResourceBytes = 0;
+	};
+
+	TMap<FName, FGroup> Groups;
+
+	FDelegateHandle PostGarbageCollectHandle;
+
+	int32 NumObjects = 0;
+};
@@ -0,0 +1,124 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "UObject/PrimaryAssetId.h"
+
+/**
+ * One caller of a request made through FAwesomeBLLoadCoalescer, pass it to CancelRequest to give up on the request
+ */
+struct FAwesomeBLLoadToken
+{
+	/** Caller within the merged request, 0 if the request was not merged */
+	uint64 WaiterId = 0;
+
+	/** Handle returned for the request */
+	TWeakPtr<FStreamableHandle> Handle;
+};
+
+/**
+ * Merges identical in-flight load requests into a single streamable request and fans the completion out to every
+ * waiting delegate. A merged request loads at the highest priority of its callers. Used by the UAwesomeBL load
+ * templates, game thread only.
+ * @note Merged callers share the returned handle. Drop it to release the assets, use CancelRequest with the caller's
+ *		 token instead of CancelHandle so the other callers are not canceled with it.
+ */
+class AWESOMEBLUEPRINTLIBRARY_API FAwesomeBLLoadCoalescer
+{
+public:
+
+	static FAwesomeBLLoadCoalescer& Get();
+
+	/**
+	 * Request an async load of a list of soft object paths, merging with an in-flight request for the same paths.
+	 * @param Paths				Paths to load, order and duplicates are ignored when merging.
+	 * @param OnLoad			Delegate to call when loading has finished.
+	 * @param Priority			Priority of the load, raises the priority of the request it merges into.
+	 * @param OutToken			Optional, set to the token identifying this caller.
+	 * @return					Handle to the possibly shared request.
+	 */
+	TSharedPtr<FStreamableHandle> RequestAsyncLoad(TArray<FSoftObjectPath> Paths, FStreamableDelegate OnLoad, TAsyncLoadPriority Priority, FAwesomeBLLoadToken* OutToken = nullptr);
+
+	/**
+	 * Load a list of primary assets, merging with an in-flight request for the same assets and bundles.
+	 * @param PrimaryAssetIds	PrimaryAssets to load, order and duplicates are ignored when merging.
+	 * @param LoadBundles		Bundles to activate with load.
+	 * @param OnLoad			Delegate to call when loading has finished.
+	 * @param Priority			Priority of the load, raises the priority of the request it merges into.
+	 * @param OutToken			Optional, set to the token identifying this caller.
+	 * @return					Handle to the possibly shared request, null if the asset manager is not initialized.
+	 */
+	TSharedPtr<FStreamableHandle> LoadPrimaryAssets(TConstArrayView<FPrimaryAssetId> PrimaryAssetIds, TConstArrayView<FName> LoadBundles, FStreamableDelegate OnLoad, TAsyncLoadPriority Priority, FAwesomeBLLoadToken* OutToken = nullptr);
+
+	/**
+	 * Give up on one caller of a request, its delegate will not be called. The underlying load is only canceled once
+	 * every merged caller gave up on it.
+	 * @param Token				Token set by RequestAsyncLoad or LoadPrimaryAssets.
+	 */
+	void CancelRequest(const FAwesomeBLLoadToken& Token);
+
+	/** @return Number of requests made through the coalescer */
+	int32 GetNumRequests() const { return NumRequests; }
+
+	/** @return Number of requests that were merged into an already in-flight request */
+	int32 GetNumMergedRequests() const { return NumMergedRequests; }
+
+	/** @return Number of underlying requests currently loading */
+	int32 GetNumInFlightRequests() const { return InFlightRequests.Num(); }
+
+	/** Reset request counters */
+	void ResetStats();
+
+private:
+
+	struct FRequestKey
+	{
+		TArray<FSoftObjectPath> Paths;
+		TArray<FPrimaryAssetId> PrimaryAssetIds;
+		TArray<FName> LoadBundles;
+		uint32 Hash = 0;
+
+		bool operator==(const FRequestKey& Other) const
+		{
+			return Hash == Other.Hash && Paths == Other.Paths && PrimaryAssetIds == Other.PrimaryAssetIds && LoadBundles == Other.LoadBundles;
+		}
+
+		friend uint32 GetTypeHash(const FRequestKey& Key) { return Key.Hash; }
+	};
+
+	struct FWaiter
+	{
+		uint64 Id = 0;
+		FStreamableDelegate OnLoad;
+	};
+
+	struct FInFlightRequest
+	{
+		FRequestKey Key;
+		TSharedPtr<FStreamableHandle> Handle;
+		TArray<FWaiter> Waiters;
+		uint64 FirstWaiterId = 0;
+		TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority;
+	};
+
+	/** Find a request to merge into, or register a new one. Returns the existing handle when merged */
+	TSharedPtr<FStreamableHandle> AddWaiter(FRequestKey&& Key, FStreamableDelegate&& OnLoad, TAsyncLoadPriority Priority, TSharedPtr<FInFlightRequest>& OutNewRequest, FAwesomeBLLoadToken* OutToken);
+
+	/** Bind the fan out delegates of a newly started request and hand out the token of its first caller */
+	void Track(const TSharedPtr<FInFlightRequest>& Request, const TSharedPtr<FStreamableHandle>& Handle, FAwesomeBLLoadToken* OutToken);
+
+	/** Request the packages of a request again at a higher priority, the loader raises packages already in flight */
+	static void RaisePriority(FInFlightRequest& Request, TAsyncLoadPriority Priority);
+
+	void OnRequestFinished(const TSharedRef<FInFlightRequest>& Request, bool bCanceled);
+
+	TMap<FRequestKey, TSharedRef<FInFlightRequest>> InFlightRequests;
+
+	/** Id of the last waiter added, 0 is reserved for callers of requests that were not merged */
+	uint64 LastWaiterId = 0;
+
+	int32 NumRequests = 0;
+	int32 NumMergedRequests = 0;
+};
@@ -0,0 +1,131 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Async.h"
+#include "Async/Future.h"
+#include "Engine/StreamableManager.h"
+#include "Tasks/Task.h"
+#include "UObject/PrimaryAssetId.h"
+
+/**
+ * Outcome of a load started by the future and task variants of the UAwesomeBL load templates
+ */
+template<class Class>
+struct TAwesomeBLLoadResult
+{
+	/** Whether every requested asset loaded, false if any failed or the load was canceled */
+	bool bSuccess = false;
+
+	/** Loaded primary assets, primary asset loads only */
+	TArray<FPrimaryAssetId> PrimaryAssetIds;
+
+	/** Loaded assets in request order, failed ones left out */
+	TArray<Class*> Assets;
+
+	/** Keeps the assets resident, may be released from any thread */
+	TSharedPtr<FStreamableHandle> Handle;
+};
+
+/**
+ * Fulfils the future of a load exactly once. A load that never completes, because it was canceled or its delegate
+ * was dropped, is fulfilled with a failed result when the last reference to the promise goes away. A load completing
+ * before its handle was set, e.g. synchronously inside the request, is held back until SetHandle so the result
+ * always carries the handle.
+ */
+template<class Class>
+class TAwesomeBLLoadPromise
+{
+public:
+
+	~TAwesomeBLLoadPromise()
+	{
+		if (Pending.IsSet())
+		{
+			Promise.SetValue(MoveTemp(Pending.GetValue()));
+		}
+		else if (!bFulfilled)
+		{
+			Promise.SetValue(TAwesomeBLLoadResult<Class>());
+		}
+	}
+
+	TFuture<TAwesomeBLLoadResult<Class>> GetFuture() { return Promise.GetFuture(); }
+
+	/** Remember the request handle, weakly since the handle's delegates reference the promise. Call once the request returned. */
+	void SetHandle(const TSharedPtr<FStreamableHandle>& InHandle)
+	{
+		Handle = InHandle;
+		bHandleSet = true;
+		if (Pending.IsSet())
+		{
+			Pending->Handle = MakeAnyThreadHandle(TSharedPtr<FStreamableHandle>(InHandle));
+			Promise.SetValue(MoveTemp(Pending.GetValue()));
+			Pending.Reset();
+		}
+	}
+
+	/**
+	 * Fulfil the future, later calls are ignored.
+	 * @param bSuccess			Whether every requested asset loaded.
+	 * @param PrimaryAssetIds	Loaded primary assets.
+	 * @param Assets			Loaded assets.
+	 */
+	void Fulfil(bool bSuccess, TConstArrayView<FPrimaryAssetId> PrimaryAssetIds, TConstArrayView<Class*> Assets)
+	{
+		if (bFulfilled)
+		{
+			return;
+		}
+		bFulfilled = true;
+
+		TAwesomeBLLoadResult<Class> Result;
+		Result.bSuccess = bSuccess;
+		Result.PrimaryAssetIds.Append(PrimaryAssetIds.GetData(), PrimaryAssetIds.Num());
+		Result.Assets.Append(Assets.GetData(), Assets.Num());
+		if (!bHandleSet)
+		{
+			Pending.Emplace(MoveTemp(Result));
+			return;
+		}
+		Result.Handle = MakeAnyThreadHandle(Handle.Pin());
+		Promise.SetValue(MoveTemp(Result));
+	}
+
+private:
+
+	/**
+	 * Streamable handles have to be released on the game thread. Continuations may run anywhere, so they get a
+	 * handle whose last release sends the real one back to the game thread.
+	 */
+	static TSharedPtr<FStreamableHandle> MakeAnyThreadHandle(TSharedPtr<FStreamableHandle>&& GameThreadHandle)
+	{
+		if (!GameThreadHandle.IsValid())
+		{
+			return nullptr;
+		}
+
+		FStreamableHandle* RawHandle = GameThreadHandle.Get();
+		return TSharedPtr<FStreamableHandle>(RawHandle, [Owner = MoveTemp(GameThreadHandle)](FStreamableHandle*) mutable
+			{
+				if (IsInGameThread())
+				{
+					Owner.Reset();
+				}
+				else
+				{
+					AsyncTask(ENamedThreads::GameThread, [Owner = MoveTemp(Owner)]() {});
+				}
+			});
+	}
+
+	TPromise<TAwesomeBLLoadResult<Class>> Promise;
+	TWeakPtr<FStreamableHandle> Handle;
+
+	/** Result of a load that completed before SetHandle */
+	TOptional<TAwesomeBLLoadResult<Class>> Pending;
+
+	bool bFulfilled = false;
+	bool bHandleSet = false;
+};
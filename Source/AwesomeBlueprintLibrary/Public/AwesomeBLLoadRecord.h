@@ -0,0 +1,178 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/PrimaryAssetId.h"
+#include "UObject/SoftObjectPtr.h"
+
+/**
+ * Shared reference to a pooled load record. Records go back to their pool once the last reference is gone and keep
+ * the capacity of their arrays, so steady state loads reuse them instead of allocating new captures. The load path
+ * only ever moves references, copies exist because the streamable delegates holding them have to be copyable.
+ * Game thread only.
+ */
+template<typename RecordType>
+class TAwesomeBLLoadRecordRef
+{
+public:
+
+	/** Take a record from the pool, or create one if the pool is empty */
+	static TAwesomeBLLoadRecordRef Acquire()
+	{
+		check(IsInGameThread());
+
+		TAwesomeBLLoadRecordRef Ref;
+		TArray<TUniquePtr<FNode>>& Pool = GetPool();
+		Ref.Node = Pool.Num() > 0 ? Pool.Pop(false).Release() : new FNode();
+		Ref.Node->RefCount = 1;
+		return Ref;
+	}
+
+	TAwesomeBLLoadRecordRef() = default;
+
+	TAwesomeBLLoadRecordRef(const TAwesomeBLLoadRecordRef& Other)
+		: Node(Other.Node)
+	{
+		if (Node)
+		{
+			++Node->RefCount;
+		}
+	}
+
+	TAwesomeBLLoadRecordRef(TAwesomeBLLoadRecordRef&& Other)
+		: Node(Other.Node)
+	{
+		Other.Node = nullptr;
+	}
+
+	TAwesomeBLLoadRecordRef& operator=(TAwesomeBLLoadRecordRef Other)
+	{
+		Swap(Node, Other.Node);
+		return *this;
+	}
+
+	~TAwesomeBLLoadRecordRef()
+	{
+		if (Node && --Node->RefCount == 0)
+		{
+			Node->Record.Reset();
+			TArray<TUniquePtr<FNode>>& Pool = GetPool();
+			if (Pool.Num() < MaxPooledRecords)
+			{
+				Pool.Emplace(Node);
+			}
+			else
+			{
+				delete Node;
+			}
+		}
+	}
+
+	RecordType* operator->() const { return &Node->Record; }
+	RecordType& operator*() const { return Node->Record; }
+
+private:
+
+	/** Past this many idle records a burst of loads is not worth holding on to */
+	static constexpr int32 MaxPooledRecords = 64;
+
+	struct FNode
+	{
+		RecordType Record;
+		int32 RefCount = 0;
+	};
+
+	static TArray<TUniquePtr<FNode>>& GetPool()
+	{
+		static TArray<TUniquePtr<FNode>> Pool;
+		return Pool;
+	}
+
+	FNode* Node = nullptr;
+};
+
+/**
+ * Everything a soft object load of the UAwesomeBL templates needs once it has loaded
+ */
+template<class Class>
+struct TAwesomeBLAssetLoadRecord
+{
+	/** Requested assets in order, most loads are a single asset */
+	TArray<TSoftObjectPtr<Class>, TInlineAllocator<1>> Assets;
+
+	/** Set for list loads */
+	TDelegate<void(const TArray<Class*>&)> OnLoad;
+
+	/** Set instead of OnLoad for single asset loads */
+	TDelegate<void(Class*)> OnSingleLoad;
+
+	/** Result handed to OnLoad, kept across reuses for its capacity */
+	TArray<Class*> LoadedAssets;
+
+	/**
+	 * Paths of the non null assets, kept across reuses for its capacity. The asset cache checks them in place, loads
+	 * sent to the streamable manager copy them since it keeps its own array.
+	 */
+	TArray<FSoftObjectPath> SoftObjectPaths;
+
+	/** When the load was sent to the streamable manager, 0 for loads served from the asset cache */
+	double RequestTime = 0.;
+
+	/** Collect the paths of the non null assets into SoftObjectPaths */
+	const TArray<FSoftObjectPath>& GatherSoftObjectPaths()
+	{
+		SoftObjectPaths.Reset(Assets.Num());
+		for (const TSoftObjectPtr<Class>& SoftObjectPointer : Assets)
+		{
+			if (!SoftObjectPointer.IsNull())
+			{
+				SoftObjectPaths.Add(SoftObjectPointer.ToSoftObjectPath());
+			}
+		}
+		return SoftObjectPaths;
+	}
+
+	void Reset()
+	{
+		Assets.Reset();
+		OnLoad.Unbind();
+		OnSingleLoad.Unbind();
+		LoadedAssets.Reset();
+		SoftObjectPaths.Reset();
+		RequestTime = 0.;
+	}
+};
+
+/**
+ * Everything a primary asset load of the UAwesomeBL templates needs once it has loaded
+ */
+template<class Class>
+struct TAwesomeBLPrimaryAssetLoadRecord
+{
+	/** Requested primary assets in order, most loads are a single asset */
+	TArray<FPrimaryAssetId, TInlineAllocator<1>> PrimaryAssetIds;
+
+	/** Set for list loads */
+	TDelegate<void(const TArray<FPrimaryAssetId>&, const TArray<Class*>&)> OnLoad;
+
+	/** Set instead of OnLoad for single asset loads */
+	TDelegate<void(const FPrimaryAssetId&, Class*)> OnSingleLoad;
+
+	/** Results handed to OnLoad, kept across reuses for their capacity */
+	TArray<FPrimaryAssetId> LoadedPrimaryAssetIds;
+	TArray<Class*> LoadedAssets;
+
+	/** When the load was sent to the streamable manager */
+	double RequestTime = 0.;
+
+	void Reset()
+	{
+		PrimaryAssetIds.Reset();
+		OnLoad.Unbind();
+		OnSingleLoad.Unbind();
+		LoadedPrimaryAssetIds.Reset();
+		LoadedAssets.Reset();
+		RequestTime = 0.;
+	}
+};
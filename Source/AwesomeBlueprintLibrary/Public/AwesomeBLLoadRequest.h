@@ -0,0 +1,84 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AwesomeBLLoadCoalescer.h"
+#include "Engine/StreamableManager.h"
+#include "UObject/Object.h"
+#include "AwesomeBLLoadRequest.generated.h"
+
+/**
+ * Blueprint facing wrapper around an FStreamableHandle. Keeps the requested assets resident until the request is
+ * released, canceled or garbage collected.
+ */
+UCLASS(BlueprintType)
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLLoadRequest : public UObject
+{
+	GENERATED_BODY()
+public:
+
+	/**
+	 * Wrap a streamable handle in a new request object.
+	 * @param InHandle			Handle returned by the streamable or asset manager, may be null.
+	 * @return					New request owning a reference to the handle.
+	 */
+	static UAwesomeBLLoadRequest* Create(TSharedPtr<FStreamableHandle> InHandle);
+
+	/** Stop keeping the assets alive. They will be free to GC out once nothing else references them. */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Loading Helpers")
+	void Release();
+
+	/**
+	 * Cancel the load if it is still in progress, the load delegate will not be called. A load merged with other
+	 * requests keeps going for them, only this request's delegate is removed. Releases the assets if already loaded.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Loading Helpers")
+	void Cancel();
+
+	/** @return Whether every requested asset has finished loading */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Loading Helpers")
+	bool IsLoadingComplete() const;
+
+	/** @return Whether the request still holds on to its assets, false once released or canceled */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Loading Helpers")
+	bool IsActive() const;
+
+	/** @return Whether the request has been canceled */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Loading Helpers")
+	bool WasCanceled() const { return bCanceled; }
+
+	/** @return Load progress between 0 and 1 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Loading Helpers")
+	float GetProgress() const;
+
+	/**
+	 * Get the assets loaded so far by this request.
+	 * @param LoadedAssets		Loaded assets, empty once released.
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Loading Helpers")
+	void GetLoadedAssets(TArray<UObject*>& LoadedAssets) const;
+
+	/** Underlying streamable handle, null once released */
+	const TSharedPtr<FStreamableHandle>& GetHandle() const { return Handle; }
+
+	/** Attach the handle, and the coalescer token Cancel uses, for a request that was created before its load was started */
+	void SetHandle(TSharedPtr<FStreamableHandle> InHandle, const FAwesomeBLLoadToken& InToken = FAwesomeBLLoadToken())
+	{
+		Handle = MoveTemp(InHandle);
+		Token = InToken;
+	}
+
+	//~ Begin UObject Interface
+	virtual void BeginDestroy() override;
+	//~ End UObject Interface
+
+private:
+
+	TSharedPtr<FStreamableHandle> Handle;
+
+	/** Identifies this request within a merged load */
+	FAwesomeBLLoadToken Token;
+
+	bool bCanceled = false;
+};
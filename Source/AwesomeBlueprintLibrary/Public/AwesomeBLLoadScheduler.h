@@ -0,0 +1,97 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "UObject/PrimaryAssetId.h"
+#include "AwesomeBLLoadScheduler.generated.h"
+
+/**
+ * Opt-in scheduler collecting the delegate-only loads made through UAwesomeBL during a frame. At the end of the frame
+ * the queued loads are sorted by priority and sent as one streamable request per frame (plus one per bundle set for
+ * primary assets), within a per-frame budget. Loads over budget carry over to the next frame.
+ * Enable with AwesomeBL.LoadScheduler.Enabled.
+ */
+UCLASS()
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLLoadScheduler : public UEngineSubsystem
+{
+	GENERATED_BODY()
+public:
+
+	/** @return The scheduler if it exists and is enabled, null otherwise */
+	static UAwesomeBLLoadScheduler* GetIfEnabled();
+
+	/**
+	 * Queue a load of soft object paths for the next batch.
+	 * @param Paths				Paths to load.
+	 * @param OnLoad			Delegate to call once the batch containing the load has finished.
+	 * @param Priority			Priority of the load, higher values are sent first.
+	 * @param OutSendTime		Optional, set to the time the load is sent. Must stay valid for as long as OnLoad is alive.
+	 */
+	void QueueAsyncLoad(TArray<FSoftObjectPath>&& Paths, FStreamableDelegate&& OnLoad, TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority, double* OutSendTime = nullptr);
+
+	/**
+	 * Queue a load of primary assets for the next batch.
+	 * @param PrimaryAssetIds	PrimaryAssets to load.
+	 * @param LoadBundles		Bundles to activate with load.
+	 * @param OnLoad			Delegate to call once the batch containing the load has finished.
+	 * @param Priority			Priority of the load, higher values are sent first.
+	 * @param OutSendTime		Optional, set to the time the load is sent. Must stay valid for as long as OnLoad is alive.
+	 */
+	void QueueLoadPrimaryAssets(TConstArrayView<FPrimaryAssetId> PrimaryAssetIds, TConstArrayView<FName> LoadBundles, FStreamableDelegate&& OnLoad, TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority, double* OutSendTime = nullptr);
+
+	/**
+	 * Send the queued loads now instead of waiting for the end of the frame.
+	 * @param bIgnoreBudget		Send everything that is queued, not just what fits in the per-frame budget.
+	 */
+	void Flush(bool bIgnoreBudget = false);
+
+	/** @return Number of loads waiting for a batch */
+	int32 GetNumQueuedLoads() const { return QueuedLoads.Num(); }
+
+	/** @return Number of batches still loading */
+	int32 GetNumBatchesInFlight() const { return InFlightBatches.Num(); }
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+private:
+
+	struct FQueuedLoad
+	{
+		TArray<FSoftObjectPath> Paths;
+		TArray<FPrimaryAssetId> PrimaryAssetIds;
+		TArray<FName> LoadBundles;
+		FStreamableDelegate OnLoad;
+		TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority;
+		double QueueTime = 0.;
+		double* SendTime = nullptr;
+	};
+
+	struct FBatch
+	{
+		TArray<FStreamableDelegate> Callbacks;
+		TSharedPtr<FStreamableHandle> Handle;
+	};
+
+	/** Create a batch and the delegate that completes it */
+	TSharedRef<FBatch> MakeBatch(FStreamableDelegate& OutOnBatchLoaded);
+
+	/** Attach the handle of a sent batch, a canceled handle finishes the batch like a completed one */
+	void SetBatchHandle(const TSharedRef<FBatch>& Batch, TSharedPtr<FStreamableHandle>&& Handle);
+
+	void FinishBatch(const TSharedRef<FBatch>& Batch);
+
+	/** Run the callbacks of a batch, at most once */
+	static void FanOut(FBatch& Batch);
+
+	TArray<FQueuedLoad> QueuedLoads;
+
+	TArray<TSharedRef<FBatch>> InFlightBatches;
+
+	FDelegateHandle EndFrameHandle;
+};
@@ -0,0 +1,96 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "UObject/PrimaryAssetId.h"
+
+DECLARE_STATS_GROUP(TEXT("AwesomeBL"), STATGROUP_AwesomeBL, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Callback"), STAT_AwesomeBL_LoadCallback, STATGROUP_AwesomeBL, AWESOMEBLUEPRINTLIBRARY_API);
+
+/**
+ * Latency and throughput counters of the UAwesomeBL loaders. Feeds the AwesomeBL stat group and CSV category, and
+ * keeps latency histograms plus the slowest loads for AwesomeBL.DumpLoadStats. Game thread only.
+ */
+class AWESOMEBLUEPRINTLIBRARY_API FAwesomeBLLoadStats
+{
+public:
+
+	static FAwesomeBLLoadStats& Get();
+
+	/** @return Whether stats are being collected, see AwesomeBL.LoadStats.Enabled, never in shipping builds */
+	static bool IsEnabled();
+
+	/** Time a load spent waiting in the load scheduler before it was sent */
+	void RecordQueueTime(double Seconds);
+
+	/** Time between requesting a list of soft object paths and its completion */
+	void RecordLoadTime(double Seconds, const FSoftObjectPath& FirstPath, int32 NumAssets);
+
+	/** Time between requesting a list of primary assets and its completion */
+	void RecordLoadTime(double Seconds, const FPrimaryAssetId& FirstPrimaryAssetId, int32 NumAssets);
+
+	/** Time spent in the load delegate of the caller */
+	void RecordCallbackTime(double Seconds);
+
+	/**
+	 * Count a loaded asset and its exclusive resource size.
+	 * @param Type				Primary asset type, or class name for plain soft object loads.
+	 * @param Asset				Loaded asset.
+	 */
+	void RecordAsset(FName Type, const UObject* Asset);
+
+	/** Print histograms, per type totals and the slowest loads */
+	void Dump(FOutputDevice& Ar) const;
+
+	/** Clear every counter */
+	void Reset();
+
+private:
+
+	/** Power of two millisecond buckets, the first one holding everything under half a millisecond */
+	struct FHistogram
+	{
+		static constexpr int32 NumBuckets = 14;
+
+		uint32 Counts[NumBuckets] = {};
+		uint32 Num = 0;
+		double TotalMs = 0.;
+		double MaxMs = 0.;
+
+		void Add(double Ms);
+		void Dump(FOutputDevice& Ar, const TCHAR* Name) const;
+	};
+
+	struct FTypeStats
+	{
+		int64 NumAssets = 0;
+		int64 Bytes = 0;
+	};
+
+	struct FSlowLoad
+	{
+		FString Description;
+		double Ms = 0.;
+	};
+
+	void RecordLoadTime(double Seconds, int32 NumAssets, TFunctionRef<FString()> Describe);
+
+	FHistogram QueueTimes;
+	FHistogram LoadTimes;
+	FHistogram CallbackTimes;
+
+	TMap<FName, FTypeStats> TypeStats;
+
+	/** Slowest loads, sorted slowest first */
+	TArray<FSlowLoad> SlowestLoads;
+
+	int64 NumLoads = 0;
+	int64 NumAssets = 0;
+	int64 NumBytes = 0;
+	double FirstLoadTime = 0.;
+	double LastLoadTime = 0.;
+};
@@ -3,6 +3,8 @@
 #pragma once
 #include "Modules/ModuleManager.h"
 
+AWESOMEBLUEPRINTLIBRARY_API DECLARE_LOG_CATEGORY_EXTERN(LogAwesomeBL, Log, All);
+
 class FAwesomeBlueprintLibraryModule : public IModuleInterface
 {
 public:
@@ -0,0 +1,74 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Caller owned storage for names converted to strings. Keep one around and convert into it again to avoid allocating
+ * once it has grown to the size of the data.
+ */
+struct AWESOMEBLUEPRINTLIBRARY_API FAwesomeBLNameArena
+{
+	/** One view per converted name into Chars, valid until the arena is converted into again or reset */
+	TArray<FStringView> Views;
+
+	/** Characters of every distinct converted name back to back */
+	FString Chars;
+
+	/** Drop the converted names, keeping the memory */
+	void Reset();
+
+private:
+
+	friend class FAwesomeBLNameBatch;
+
+	/** Start and length in Chars per converted name, views are only made once Chars stopped growing */
+	TArray<TPair<int32, int32>> Ranges;
+
+	/**
+	 * Index in Ranges of the first occurrence of every name, keyed on display index and number since FName equality
+	 * ignores case and names that only differ in casing must keep their own string.
+	 */
+	TMap<TPair<FNameEntryId, int32>, int32> FirstIndices;
+};
+
+/**
+ * Conversions between whole arrays of names and strings that go to the global name table once per distinct value
+ * and reuse caller memory where they can.
+ */
+class AWESOMEBLUEPRINTLIBRARY_API FAwesomeBLNameBatch
+{
+public:
+
+	/**
+	 * Convert names to string views into an arena. Repeated names share their characters.
+	 * @param Names				Names to convert.
+	 * @param Arena				Receives one view per name, in order.
+	 */
+	static void ToStringViews(TConstArrayView<FName> Names, FAwesomeBLNameArena& Arena);
+
+	/**
+	 * Convert names to strings, reusing the strings already in Target so matching elements don't allocate.
+	 * @param Names				Names to convert.
+	 * @param Target			Receives one string per name, in order.
+	 */
+	static void ToStrings(TConstArrayView<FName> Names, TArray<FString>& Target);
+
+	/**
+	 * Split names into their display entry and number, e.g. to group or sort by string without converting.
+	 * Turn them back into names with FName::CreateFromDisplayId.
+	 * @param Names				Names to split.
+	 * @param OutEntryIds		Receives the display entry of each name.
+	 * @param OutNumbers		Receives the number of each name, may be null.
+	 */
+	static void ToEntryIds(TConstArrayView<FName> Names, TArray<FNameEntryId>& OutEntryIds, TArray<int32>* OutNumbers = nullptr);
+
+	/**
+	 * Intern strings as names. Large arrays look repeated strings up in a local cache instead of the global name table.
+	 * @param Strings			Strings to intern.
+	 * @param Target			Receives one name per string, in order.
+	 * @param FindType			FNAME_Find returns None for strings that are not a name yet instead of adding them.
+	 */
+	static void ToNames(TConstArrayView<FString> Strings, TArray<FName>& Target, EFindName FindType = FNAME_Add);
+};
@@ -0,0 +1,202 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AwesomeBLLoadCoalescer.h"
+#include "Containers/Ticker.h"
+#include "Engine/DataTable.h"
+#include "Engine/DeveloperSettings.h"
+#include "GameplayTagContainer.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "UObject/PrimaryAssetId.h"
+#include "AwesomeBLPrefetcher.generated.h"
+
+/**
+ * Designer authored prefetch hint, a row of UAwesomeBLPrefetchSettings::HintTable
+ */
+USTRUCT(BlueprintType)
+struct FAwesomeBLPrefetchHint : public FTableRowBase
+{
+	GENERATED_BODY()
+public:
+
+	/** Tagged requests carrying any of these tags trigger the hint */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Prefetch")
+	FGameplayTagContainer Tags;
+
+	/** Only trigger on requests for this primary asset, any request when left empty */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Prefetch")
+	FPrimaryAssetId After;
+
+	/** Primary assets to prefetch */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Prefetch")
+	TArray<FPrimaryAssetId> Prefetch;
+};
+
+/**
+ * Configuration of UAwesomeBLPrefetcher
+ */
+UCLASS(config=Game, defaultconfig, meta=(DisplayName="Awesome Blueprint Library Prefetch"))
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLPrefetchSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+public:
+
+	UAwesomeBLPrefetchSettings();
+
+	/** Whether to prefetch at all */
+	UPROPERTY(config, EditAnywhere, Category="Prefetch")
+	bool bEnabled = false;
+
+	/** Learn which primary assets follow each other in tagged requests */
+	UPROPERTY(config, EditAnywhere, Category="Prefetch")
+	bool bLearn = true;
+
+	/** Table of FAwesomeBLPrefetchHint rows, applied on top of what was learned */
+	UPROPERTY(config, EditAnywhere, Category="Prefetch", meta=(RequiredAssetDataTags="RowStructure=/Script/AwesomeBlueprintLibrary.AwesomeBLPrefetchHint"))
+	TSoftObjectPtr<UDataTable> HintTable;
+
+	/** Times a follow-up has to be seen before it is prefetched */
+	UPROPERTY(config, EditAnywhere, Category="Prefetch", meta=(ClampMin=1))
+	int32 MinObservations = 2;
+
+	/** Most likely follow-ups prefetched per request and tag */
+	UPROPERTY(config, EditAnywhere, Category="Prefetch", meta=(ClampMin=1))
+	int32 MaxPredictions = 2;
+
+	/** Memory prefetched assets may use before the oldest are dropped, in megabytes */
+	UPROPERTY(config, EditAnywhere, Category="Prefetch", meta=(ClampMin=0))
+	int32 MemoryBudgetMB = 64;
+
+	/** Prefetches loading at the same time, their size is unknown until loaded so this bounds how far they overshoot the budget */
+	UPROPERTY(config, EditAnywhere, Category="Prefetch", meta=(ClampMin=1))
+	int32 MaxInFlight = 4;
+
+	/** Seconds a prefetched asset waits for its request before it is dropped as wasted */
+	UPROPERTY(config, EditAnywhere, Category="Prefetch", meta=(ClampMin=0))
+	float LifetimeSeconds = 30.f;
+
+	/** Priority of the prefetch loads, below the default of 0 so real requests go first */
+	UPROPERTY(config, EditAnywhere, Category="Prefetch")
+	int32 Priority = -100;
+};
+
+/**
+ * Prefetcher counters since the last reset
+ */
+USTRUCT(BlueprintType)
+struct FAwesomeBLPrefetchStats
+{
+	GENERATED_BODY()
+public:
+
+	/** Prefetch loads started */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Prefetch")
+	int32 NumPrefetches = 0;
+
+	/** Tagged requests for an asset that had been prefetched */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Prefetch")
+	int32 NumHits = 0;
+
+	/** Prefetched assets dropped without being requested */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Prefetch")
+	int32 NumWasted = 0;
+
+	/** Predictions not prefetched because the budget or MaxInFlight was used up */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Prefetch")
+	int32 NumOverBudget = 0;
+
+	/** Estimated memory of the prefetched assets waiting for their request */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Prefetch")
+	int64 PrefetchedBytes = 0;
+};
+
+/**
+ * Prefetches the primary assets likely to be requested next by UAwesomeBL::AsyncLoadPrimaryAssetWithTags and
+ * AsyncLoadPrimaryAssetsWithTags. For every gameplay tag of a request it learns which primary asset was requested
+ * after the previous one carrying the same tag, and reads designer hints from UAwesomeBLPrefetchSettings::HintTable.
+ * Predictions are loaded at low priority through FAwesomeBLLoadCoalescer and held by their own streamable handle, so a
+ * real request made while the prefetch is in flight shares its package loads. Prefetched assets that are not requested
+ * within LifetimeSeconds, or that push the prefetched memory over budget, have their handle released and are counted as
+ * wasted, which leaves assets other requests hold loaded.
+ * Enable in the project settings, report with AwesomeBL.DumpPrefetch.
+ */
+UCLASS()
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLPrefetcher : public UEngineSubsystem
+{
+	GENERATED_BODY()
+public:
+
+	/** @return The prefetcher if it exists and is enabled, null otherwise */
+	static UAwesomeBLPrefetcher* GetIfEnabled();
+
+	/**
+	 * Learn from a tagged request and prefetch what is likely to follow it. Called by the tagged load nodes.
+	 * @param Tags				Tags the request was made with.
+	 * @param PrimaryAssetIds	PrimaryAssets requested.
+	 */
+	void OnTaggedRequest(const FGameplayTagContainer& Tags, TConstArrayView<FPrimaryAssetId> PrimaryAssetIds);
+
+	/** @return Counters since the last reset */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Prefetch")
+	FAwesomeBLPrefetchStats GetStats() const;
+
+	/** Reset the counters, learned follow-ups are kept */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Prefetch")
+	void ResetStats();
+
+	/** Forget the learned follow-ups */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Prefetch")
+	void ForgetLearned();
+
+	/** Log the counters and the pending prefetches */
+	void Dump(FOutputDevice& Ar) const;
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+private:
+
+	/** Learned follow-ups are capped per key, the least seen one makes room */
+	static constexpr int32 MaxFollowUps = 8;
+
+	struct FPrefetch
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		FAwesomeBLLoadToken Token;
+		double StartTime = 0.;
+		int64 Bytes = 0;
+	};
+
+	void Learn(const FGameplayTagContainer& Tags, const FPrimaryAssetId& PrimaryAssetId);
+	void Predict(const FGameplayTagContainer& Tags, const FPrimaryAssetId& PrimaryAssetId, TArray<FPrimaryAssetId>& OutPredictions) const;
+	void StartPrefetch(const FPrimaryAssetId& PrimaryAssetId);
+	void OnPrefetchLoaded(FPrimaryAssetId PrimaryAssetId);
+
+	/** Drop expired prefetches, then the oldest ones until the budget is met */
+	void EnforceLimits(int64 BudgetBytes);
+	void DropPrefetch(const FPrimaryAssetId& PrimaryAssetId);
+
+	/** @return Number of prefetches still loading */
+	int32 GetNumInFlight() const;
+
+	bool Tick(float DeltaTime);
+
+	/** Follow-up counts keyed by tag and the asset requested before */
+	TMap<TPair<FGameplayTag, FPrimaryAssetId>, TMap<FPrimaryAssetId, int32>> FollowUps;
+
+	/** Last asset requested with each tag */
+	TMap<FGameplayTag, FPrimaryAssetId> LastRequested;
+
+	/** Prefetches waiting for their request */
+	TMap<FPrimaryAssetId, FPrefetch> Prefetches;
+
+	TSharedPtr<FStreamableHandle> HintTableHandle;
+
+	FAwesomeBLPrefetchStats Stats;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,132 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "UObject/PrimaryAssetId.h"
+#include "AwesomeBLPrimaryAssetResidency.generated.h"
+
+/**
+ * Who keeps a primary asset loaded through the residency subsystem
+ */
+USTRUCT(BlueprintType)
+struct FAwesomeBLPrimaryAssetResidencyEntry
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Residency")
+	FPrimaryAssetId PrimaryAssetId;
+
+	/** Whether the primary asset object is currently loaded */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Residency")
+	bool bLoaded = false;
+
+	/** Bundles held for it through the residency subsystem */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Residency")
+	TArray<FName> Bundles;
+
+	/** Names of the live holders, one entry per acquire */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Residency")
+	TArray<FString> Holders;
+};
+
+/**
+ * Reference counts primary assets, so they can be unloaded again once nothing needs them. Every acquire is paired
+ * with a holder object and keeps its own streamable handle on the primary asset and the content of its bundles. The
+ * bundle state of the asset manager is never changed, so holds don't strip bundles other holders or loads activated.
+ * A hold's handle is released when its holder releases it or is garbage collected, the content unloads once no
+ * other handle references it.
+ */
+UCLASS()
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLPrimaryAssetResidency : public UEngineSubsystem
+{
+	GENERATED_BODY()
+public:
+
+	/** @return The subsystem, null before the engine is up */
+	static UAwesomeBLPrimaryAssetResidency* Get();
+
+	/**
+	 * Load primary assets and keep them resident for as long as Holder holds them.
+	 * @param Holder			Object holding the assets. Garbage collecting it releases them.
+	 * @param PrimaryAssetIds	PrimaryAssets to be loaded.
+	 * @param LoadBundles		Bundles to keep loaded along with the assets.
+	 * @param Priority			Priority of the load, higher loads first.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Residency", meta=(AutoCreateRefTerm="LoadBundles"))
+	void AcquirePrimaryAssets(UObject* Holder, const TArray<FPrimaryAssetId>& PrimaryAssetIds, const TArray<FName>& LoadBundles, int32 Priority = 0);
+
+	/**
+	 * Drop one hold of Holder on each primary asset, unloading the ones nothing holds anymore.
+	 * @param Holder			Object that acquired the assets.
+	 * @param PrimaryAssetIds	PrimaryAssets to release.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Residency")
+	void ReleasePrimaryAssets(UObject* Holder, const TArray<FPrimaryAssetId>& PrimaryAssetIds);
+
+	/**
+	 * Drop every hold of Holder, unloading the primary assets nothing holds anymore.
+	 * @param Holder			Object that acquired the assets.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Residency")
+	void ReleaseAllPrimaryAssets(UObject* Holder);
+
+	/**
+	 * Add and remove bundles of the holds Holder has on primary assets. Bundles other holders hold stay loaded.
+	 * @param Holder			Object that acquired the assets.
+	 * @param PrimaryAssetIds	PrimaryAssets to change.
+	 * @param AddBundles		Bundles to load.
+	 * @param RemoveBundles		Bundles to let unload.
+	 * @param Priority			Priority of the load, higher loads first.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Residency", meta=(AutoCreateRefTerm="AddBundles,RemoveBundles"))
+	void ChangeBundleStateForPrimaryAssets(UObject* Holder, const TArray<FPrimaryAssetId>& PrimaryAssetIds, const TArray<FName>& AddBundles, const TArray<FName>& RemoveBundles, int32 Priority = 0);
+
+	/** @return Number of live holds on a primary asset */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Residency")
+	int32 GetReferenceCount(const FPrimaryAssetId& PrimaryAssetId) const;
+
+	/** @return Every held primary asset with its holders */
+	UFUNCTION(BlueprintCallable, Category="Awesome Blueprint Library|Residency")
+	TArray<FAwesomeBLPrimaryAssetResidencyEntry> GetResidencyReport() const;
+
+	/** Log the residency report */
+	void Dump(FOutputDevice& Ar) const;
+
+	//~ Begin USubsystem Interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~ End USubsystem Interface
+
+private:
+
+	struct FHold
+	{
+		TWeakObjectPtr<UObject> Holder;
+		TArray<FName> Bundles;
+
+		/** Keeps the primary asset and the content of Bundles loaded */
+		TSharedPtr<FStreamableHandle> Handle;
+	};
+
+	/** Drop holders that were garbage collected */
+	void PurgeDeadHolders();
+
+	/** Release every hold matching Predicate and forget assets nothing holds anymore */
+	template<typename PredicateType>
+	void ReleaseHolds(const PredicateType& Predicate);
+
+	/** Request a handle on a primary asset and the content of its bundles */
+	static TSharedPtr<FStreamableHandle> LoadHold(const FPrimaryAssetId& PrimaryAssetId, const TArray<FName>& Bundles, int32 Priority);
+
+	/** Stop or release a hold's handle, leaving content other handles reference loaded */
+	static void ReleaseHandle(TSharedPtr<FStreamableHandle>& Handle);
+
+	/** One entry per acquire, a holder acquiring twice has to release twice */
+	TMap<FPrimaryAssetId, TArray<FHold>> Holders;
+
+	FDelegateHandle PostGarbageCollectHandle;
+};
@@ -0,0 +1,31 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Named profiling scopes opened and closed from Blueprint. Each scope shows up as a timing region in Unreal Insights
+ * and as a custom stat in the AwesomeBL CSV category, accumulated into the frame the scope is closed in. Scopes are
+ * not native CPU events, so they may stay open across frames, overlap rather than nest, and be closed from another
+ * thread than the one that opened them.
+ */
+class AWESOMEBLUEPRINTLIBRARY_API FAwesomeBLProfiling
+{
+public:
+
+	/**
+	 * Open a scope.
+	 * @param Name				Name of the scope in Insights and CSV captures.
+	 */
+	static void BeginScope(FName Name);
+
+	/**
+	 * Close the most recently opened scope with this name.
+	 * @param Name				Name the scope was opened with.
+	 */
+	static void EndScope(FName Name);
+
+	/** @return Number of scopes open */
+	static int32 GetNumOpenScopes();
+};
@@ -0,0 +1,88 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UPackage;
+
+/**
+ * Watches the game thread for synchronous package loads and async loading flushes, the hitches the plugin's async
+ * loaders exist to avoid. Each one is recorded with the package, its duration and the Blueprint callstack that caused
+ * it. Loads over AwesomeBL.SyncLoadMonitor.ThresholdMs, and those without a duration, are warned about, at most once per
+ * AwesomeBL.SyncLoadMonitor.WarningInterval seconds for each call site.
+ * A sync load ends when the loader reports its package as loaded. Flushes, and sync loads whose end is not reported by
+ * the end of the frame, are only counted, as nothing signals when they return.
+ * Enable with AwesomeBL.SyncLoadMonitor.Enabled, report with AwesomeBL.DumpSyncLoads. Game thread only.
+ */
+class AWESOMEBLUEPRINTLIBRARY_API FAwesomeBLSyncLoadMonitor
+{
+public:
+
+	static FAwesomeBLSyncLoadMonitor& Get();
+
+	/** Start or stop watching, follows AwesomeBL.SyncLoadMonitor.Enabled */
+	void SetEnabled(bool bEnabled);
+
+	/** @return Whether the monitor is watching */
+	bool IsEnabled() const { return SyncLoadHandle.IsValid(); }
+
+	/**
+	 * Print the slowest call sites.
+	 * @param Ar				Device to print to.
+	 * @param MaxCallSites		Number of call sites to print.
+	 */
+	void Dump(FOutputDevice& Ar, int32 MaxCallSites = 20) const;
+
+	/** Forget every recorded call site */
+	void Reset();
+
+private:
+
+	FAwesomeBLSyncLoadMonitor() = default;
+
+	/** Sync loads and flushes from the same place with the same Blueprint callstack */
+	struct FCallSite
+	{
+		FString What;
+		FString Callstack;
+		int32 Count = 0;
+
+		/** Loads with a known duration, TotalMs and MaxMs only cover those */
+		int32 NumTimed = 0;
+		double TotalMs = 0.;
+		double MaxMs = 0.;
+		double LastWarningTime = -DBL_MAX;
+	};
+
+	struct FPendingLoad
+	{
+		/** None for flushes */
+		FName PackageName;
+		FString Callstack;
+		double StartTime = 0.;
+	};
+
+	void OnSyncLoadPackage(const FString& PackageName);
+	void OnAsyncLoadingFlush();
+	void OnEndLoadPackage(TConstArrayView<UPackage*> LoadedPackages);
+	void OnEndFrame();
+
+	/**
+	 * Add a load to its call site and warn about it if needed.
+	 * @param What				Package or flush that was loaded.
+	 * @param Callstack			Blueprint callstack of the load.
+	 * @param Seconds			Duration of the load, unset if unknown.
+	 */
+	void Record(const FString& What, const FString& Callstack, TOptional<double> Seconds);
+
+	TArray<FPendingLoad> PendingLoads;
+
+	/** Keyed by what was loaded and the callstack */
+	TMap<FString, FCallSite> CallSites;
+
+	FDelegateHandle SyncLoadHandle;
+	FDelegateHandle FlushHandle;
+	FDelegateHandle EndLoadPackageHandle;
+	FDelegateHandle EndFrameHandle;
+};
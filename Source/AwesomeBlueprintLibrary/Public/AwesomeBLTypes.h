@@ -6,6 +6,9 @@
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "AwesomeBLTypes.generated.h"
 
+class AActor;
+class UActorComponent;
+
 /**
  * Wrapper to expose FComponentReference to blueprints with the component picker enabled
  */
@@ -34,6 +37,31 @@ public:
 	
 };
 
+/**
+ * Progress of an incremental list load
+ */
+USTRUCT(BlueprintType)
+struct FAwesomeBLLoadProgress
+{
+	GENERATED_BODY()
+public:
+
+	/** Assets delivered so far */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Types")
+	int32 NumLoaded = 0;
+
+	/** Assets requested, null entries excluded */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Types")
+	int32 NumTotal = 0;
+
+	/** Exclusive resource size of the assets delivered so far, 0 where the size is not known */
+	UPROPERTY(BlueprintReadOnly, Category="Awesome Blueprint Library|Types")
+	int64 LoadedBytes = 0;
+
+	/** @return Fraction of the assets delivered between 0 and 1 */
+	float GetFraction() const { return NumTotal > 0 ? static_cast<float>(NumLoaded) / NumTotal : 1.f; }
+};
+
 /**
  * 
  */
@@ -48,4 +76,25 @@ public:
 
 	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Conversion", meta=(NativeBreakFunc, CompactNodeTitle = "->", BlueprintThreadSafe, BlueprintAutocast))
 	static void Conv_SoftComponentReferenceWrapperToSoftComponentReference(const FSoftComponentReferenceWrapper& Wrapper, FSoftComponentReference& OutSoftComponentReference);
+
+	/**
+	 * Resolve one component reference against many actors in a single call, in parallel for large arrays.
+	 * @param Wrapper			Reference to resolve.
+	 * @param Actors			Actors to search on. Ignored if the reference has OtherActor set.
+	 * @param OutComponents		Found component per actor, null where the reference did not resolve.
+	 */
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Conversion", meta=(BlueprintThreadSafe))
+	static void GetComponentsFromActors(const FComponentReferenceWrapper& Wrapper, const TArray<AActor*>& Actors, TArray<UActorComponent*>& OutComponents);
+
+	/**
+	 * Resolve one soft component reference against many actors in a single call, in parallel for large arrays.
+	 * @param Wrapper			Reference to resolve.
+	 * @param Actors			Actors to search on. Ignored if the reference has a loaded OtherActor.
+	 * @param OutComponents		Found component per actor, null where the reference did not resolve.
+	 */
+	UFUNCTION(BlueprintPure, DisplayName="Get Components From Actors", Category="Awesome Blueprint Library|Conversion", meta=(BlueprintThreadSafe))
+	static void GetComponentsFromActorsSoft(const FSoftComponentReferenceWrapper& Wrapper, const TArray<AActor*>& Actors, TArray<UActorComponent*>& OutComponents);
+
+	UFUNCTION(BlueprintPure, Category="Awesome Blueprint Library|Loading Helpers", meta=(BlueprintThreadSafe))
+	static float GetLoadProgressFraction(const FAwesomeBLLoadProgress& Progress) { return Progress.GetFraction(); }
 };
@@ -0,0 +1,105 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "UObject/PrimaryAssetId.h"
+#include "AwesomeBLWarmUp.generated.h"
+
+struct FStreamableHandle;
+
+/**
+ * Primary assets to preload together during the loading screen
+ */
+USTRUCT()
+struct FAwesomeBLWarmUpItem
+{
+	GENERATED_BODY()
+public:
+
+	/** Load every primary asset of this type, leave empty to only load PrimaryAssetIds */
+	UPROPERTY(EditAnywhere, Category="Warm-Up")
+	FPrimaryAssetType PrimaryAssetType;
+
+	/** Primary assets to load on top of the ones of PrimaryAssetType */
+	UPROPERTY(EditAnywhere, Category="Warm-Up")
+	TArray<FPrimaryAssetId> PrimaryAssetIds;
+
+	/** Bundles to activate with load */
+	UPROPERTY(EditAnywhere, Category="Warm-Up")
+	TArray<FName> LoadBundles;
+};
+
+/**
+ * Primary assets the plugin loads while the loading screen is up and keeps resident, so their first use during
+ * gameplay doesn't hitch.
+ */
+UCLASS(config=Game, defaultconfig, meta=(DisplayName="Awesome Blueprint Library Warm-Up"))
+class AWESOMEBLUEPRINTLIBRARY_API UAwesomeBLWarmUpSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+public:
+
+	UAwesomeBLWarmUpSettings();
+
+	/** Whether to warm up at all */
+	UPROPERTY(config, EditAnywhere, Category="Warm-Up")
+	bool bEnabled = true;
+
+	/** Priority of the warm-up loads, higher loads first */
+	UPROPERTY(config, EditAnywhere, Category="Warm-Up")
+	int32 Priority = 0;
+
+	/** Items are loaded in parallel, each is timed on its own */
+	UPROPERTY(config, EditAnywhere, Category="Warm-Up")
+	TArray<FAwesomeBLWarmUpItem> Items;
+};
+
+/**
+ * Runs the warm-up configured in UAwesomeBLWarmUpSettings once the asset manager has finished its initial scan.
+ * Every item is requested at once through UAwesomeBL::TRequestAsyncLoadPrimaryAssetList, and the handles are held
+ * until Release is called.
+ */
+class AWESOMEBLUEPRINTLIBRARY_API FAwesomeBLWarmUp
+{
+public:
+
+	static FAwesomeBLWarmUp& Get();
+
+	/** Start the warm-up once the asset manager is ready. Called by the module at startup */
+	void Start();
+
+	/** Let go of the warm-up handles, the assets unload once nothing else references them */
+	void Release();
+
+	/** @return Whether every item has finished loading, also true once a disabled or empty warm-up has started */
+	bool IsComplete() const { return bStarted && NumPending == 0; }
+
+	/** Broadcast once every item has finished loading, or right away when there is nothing to warm up */
+	FSimpleMulticastDelegate OnComplete;
+
+private:
+
+	FAwesomeBLWarmUp() = default;
+
+	struct FItemState
+	{
+		FString Name;
+		int32 NumAssets = 0;
+		double StartTime = 0.;
+		double ResolveTime = 0.;
+		bool bDone = false;
+		TSharedPtr<FStreamableHandle> Handle;
+	};
+
+	void RegisterInitialScanCallback();
+	void OnCompletedInitialScan();
+	void OnItemLoaded(int32 ItemIndex);
+
+	TArray<FItemState> Items;
+	int32 NumPending = 0;
+	double StartTime = 0.;
+	bool bStarted = false;
+	FDelegateHandle PostEngineInitHandle;
+};
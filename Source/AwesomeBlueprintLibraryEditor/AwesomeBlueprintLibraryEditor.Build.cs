@@ -0,0 +1,34 @@
+// Some copyright should be here...
+
+using UnrealBuildTool;
+
+public class AwesomeBlueprintLibraryEditor : ModuleRules
+{
+	public AwesomeBlueprintLibraryEditor(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"AwesomeBlueprintLibrary"
+			}
+			);
+		
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"CoreUObject",
+				"Engine",
+				"AssetRegistry",
+				"GameplayTags",
+				"BlueprintGraph",
+				"KismetCompiler",
+				"UnrealEd",
+				"Slate",
+				"SlateCore"
+			}
+			);
+	}
+}
@@ -0,0 +1,17 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#include "AwesomeBLEditorModule.h"
+
+#define LOCTEXT_NAMESPACE "FAwesomeBlueprintLibraryEditorModule"
+
+void FAwesomeBlueprintLibraryEditorModule::StartupModule()
+{
+}
+
+void FAwesomeBlueprintLibraryEditorModule::ShutdownModule()
+{
+}
+
+#undef LOCTEXT_NAMESPACE
+	
+IMPLEMENT_MODULE(FAwesomeBlueprintLibraryEditorModule, AwesomeBlueprintLibraryEditor)
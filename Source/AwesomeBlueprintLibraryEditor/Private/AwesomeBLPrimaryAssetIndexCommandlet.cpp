@@ -0,0 +1,29 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "AwesomeBLPrimaryAssetIndexCommandlet.h"
+
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AwesomeBLAssetSnapshot.h"
+#include "Engine/AssetManager.h"
+
+UAwesomeBLPrimaryAssetIndexCommandlet::UAwesomeBLPrimaryAssetIndexCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UAwesomeBLPrimaryAssetIndexCommandlet::Main(const FString& Params)
+{
+	FString Filename = FAwesomeBLAssetSnapshot::GetDefaultFilename();
+	FParse::Value(*Params, TEXT("Output="), Filename);
+
+	// Commandlets don't wait for the registry, scan everything before asking the asset manager.
+	IAssetRegistry::GetChecked().SearchAllAssets(true);
+	UAssetManager& AssetManager = UAssetManager::Get();
+	AssetManager.RefreshPrimaryAssetDirectory(true);
+
+	return FAwesomeBLAssetSnapshot::Write(Filename) ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+
+#include "K2Node_AwesomeBLLiteralGameplayTag.h"
+
+#include "AwesomeBL.h"
+#include "BlueprintActionDatabaseRegistrar.h"
+#include "BlueprintGameplayTagLibrary.h"
+#include "BlueprintNodeSpawner.h"
+#include "EdGraphSchema_K2.h"
+#include "GameplayTagContainer.h"
+#include "K2Node_CallFunction.h"
+#include "KismetCompiler.h"
+
+#define LOCTEXT_NAMESPACE "K2Node_AwesomeBLLiteralGameplayTag"
+
+namespace AwesomeBLLiteralGameplayTag
+{
+	const FName TagNamePinName(TEXT("Tag"));
+}
+
+void UK2Node_AwesomeBLLiteralGameplayTag::AllocateDefaultPins()
+{
+	CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Name, AwesomeBLLiteralGameplayTag::TagNamePinName);
+	CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Struct, FGameplayTag::StaticStruct(), UEdGraphSchema_K2::PN_ReturnValue);
+
+	Super::AllocateDefaultPins();
+}
+
+FText UK2Node_AwesomeBLLiteralGameplayTag::GetNodeTitle(ENodeTitleType::Type TitleType) const
+{
+	return LOCTEXT("NodeTitle", "Make Literal Gameplay Tag");
+}
+
+FText UK2Node_AwesomeBLLiteralGameplayTag::GetTooltipText() const
+{
+	return LOCTEXT("NodeTooltip", "Make a literal GameplayTag from a Name.\nA typed in name is checked when the Blueprint compiles and baked in as a constant, so the graph does no tag lookup at runtime.");
+}
+
+void UK2Node_AwesomeBLLiteralGameplayTag::GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const
+{
+	UClass* ActionKey = GetClass();
+	if (ActionRegistrar.IsOpenForRegistration(ActionKey))
+	{
+		UBlueprintNodeSpawner* NodeSpawner = UBlueprintNodeSpawner::Create(GetClass());
+		check(NodeSpawner);
+		ActionRegistrar.AddBlueprintAction(ActionKey, NodeSpawner);
+	}
+}
+
+FText UK2Node_AwesomeBLLiteralGameplayTag::GetMenuCategory() const
+{
+	return LOCTEXT("MenuCategory", "Awesome Blueprint Library|Data Helpers");
+}
+
+void UK2Node_AwesomeBLLiteralGameplayTag::ValidateNodeDuringCompilation(FCompilerResultsLog& MessageLog) const
+{
+	Super::ValidateNodeDuringCompilation(MessageLog);
+
+	const FName TagName = GetLiteralTagName();
+	if (IsLiteral() && !TagName.IsNone() && !FGameplayTag::RequestGameplayTag(TagName, false).IsValid())
+	{
+		MessageLog.Error(*FText::Format(LOCTEXT("UnknownTag", "@@ uses '{0}', which is not a registered GameplayTag"), FText::FromName(TagName)).ToString(), this);
+	}
+}
+
+void UK2Node_AwesomeBLLiteralGameplayTag::ExpandNode(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
+{
+	Super::ExpandNode(CompilerContext, SourceGraph);
+
+	UK2Node_CallFunction* CallFunction = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
+	if (IsLiteral())
+	{
+		// Identity function taking the tag as a literal struct, the resolved tag ends up in the bytecode.
+		CallFunction->FunctionReference.SetExternalMember(GET_FUNCTION_NAME_CHECKED(UBlueprintGameplayTagLibrary, MakeLiteralGameplayTag), UBlueprintGameplayTagLibrary::StaticClass());
+		CallFunction->AllocateDefaultPins();
+
+		const FGameplayTag Tag = FGameplayTag::RequestGameplayTag(GetLiteralTagName(), false);
+		UEdGraphPin* ValuePin = CallFunction->FindPinChecked(TEXT("Value"));
+		CompilerContext.GetSchema()->TrySetDefaultValue(*ValuePin, FString::Printf(TEXT("(TagName=\"%s\")"), *Tag.GetTagName().ToString()));
+	}
+	else
+	{
+		CallFunction->FunctionReference.SetExternalMember(GET_FUNCTION_NAME_CHECKED(UAwesomeBL, MakeLiteralGameplayTag), UAwesomeBL::StaticClass());
+		CallFunction->AllocateDefaultPins();
+		CompilerContext.MovePinLinksToIntermediate(*GetTagNamePin(), *CallFunction->FindPinChecked(AwesomeBLLiteralGameplayTag::TagNamePinName));
+	}
+
+	CompilerContext.MovePinLinksToIntermediate(*GetTagPin(), *CallFunction->GetReturnValuePin());
+	BreakAllNodeLinks();
+}
+
+UEdGraphPin* UK2Node_AwesomeBLLiteralGameplayTag::GetTagNamePin() const
+{
+	return FindPinChecked(AwesomeBLLiteralGameplayTag::TagNamePinName, EGPD_Input);
+}
+
+UEdGraphPin* UK2Node_AwesomeBLLiteralGameplayTag::GetTagPin() const
+{
+	return FindPinChecked(UEdGraphSchema_K2::PN_ReturnValue, EGPD_Output);
+}
+
+bool UK2Node_AwesomeBLLiteralGameplayTag::IsLiteral() const
+{
+	return GetTagNamePin()->LinkedTo.IsEmpty();
+}
+
+FName UK2Node_AwesomeBLLiteralGameplayTag::GetLiteralTagName() const
+{
+	return FName(*GetTagNamePin()->GetDefaultAsString());
+}
+
+#undef LOCTEXT_NAMESPACE
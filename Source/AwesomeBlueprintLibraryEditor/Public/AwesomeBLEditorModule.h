@@ -0,0 +1,13 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+#include "Modules/ModuleManager.h"
+
+class FAwesomeBlueprintLibraryEditorModule : public IModuleInterface
+{
+public:
+
+	/** IModuleInterface implementation */
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+};
@@ -0,0 +1,24 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AwesomeBLPrimaryAssetIndexCommandlet.generated.h"
+
+/**
+ * Writes the primary asset snapshot the runtime maps at startup, see FAwesomeBLAssetSnapshot. Run it before cooking:
+ * UnrealEditor-Cmd <Project> -run=AwesomeBLPrimaryAssetIndex [-Output=<File>]
+ */
+UCLASS()
+class UAwesomeBLPrimaryAssetIndexCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+
+	UAwesomeBLPrimaryAssetIndexCommandlet();
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
@@ -0,0 +1,44 @@
+// Copyright Mortal Games. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "K2Node.h"
+#include "K2Node_AwesomeBLLiteralGameplayTag.generated.h"
+
+/**
+ * Make Literal Gameplay Tag with the lookup done at compile time. A literal tag name is validated when the Blueprint
+ * compiles and baked into the graph as a constant FGameplayTag. A connected name pin still resolves at runtime through
+ * UAwesomeBL::MakeLiteralGameplayTag.
+ */
+UCLASS()
+class AWESOMEBLUEPRINTLIBRARYEDITOR_API UK2Node_AwesomeBLLiteralGameplayTag : public UK2Node
+{
+	GENERATED_BODY()
+public:
+
+	//~ Begin UEdGraphNode Interface
+	virtual void AllocateDefaultPins() override;
+	virtual FText GetNodeTitle(ENodeTitleType::Type TitleType) const override;
+	virtual FText GetTooltipText() const override;
+	//~ End UEdGraphNode Interface
+
+	//~ Begin UK2Node Interface
+	virtual bool IsNodePure() const override { return true; }
+	virtual void GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const override;
+	virtual FText GetMenuCategory() const override;
+	virtual void ValidateNodeDuringCompilation(FCompilerResultsLog& MessageLog) const override;
+	virtual void ExpandNode(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph) override;
+	//~ End UK2Node Interface
+
+private:
+
+	UEdGraphPin* GetTagNamePin() const;
+	UEdGraphPin* GetTagPin() const;
+
+	/** @return Whether the tag name is a literal that can be resolved at compile time */
+	bool IsLiteral() const;
+
+	/** @return Name typed into the tag name pin */
+	FName GetLiteralTagName() const;
+};